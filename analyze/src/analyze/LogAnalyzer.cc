@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "analyze/LogAnalyzer.h"
+
+#include <jsoncpp/json/json.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <thread>
+
+namespace {
+const char TOTAL_TICKS[] = "Total simulation ticks:";
+
+bool startsWith(const char* _begin, const char* _end, const char* _prefix) {
+  u64 len = strlen(_prefix);
+  return (u64)(_end - _begin) >= len && memcmp(_begin, _prefix, len) == 0;
+}
+
+// this finds the next " : " separator, returns _end if not found
+const char* findSeparator(const char* _begin, const char* _end) {
+  for (const char* c = _begin; c + 2 < _end; c++) {
+    if (c[0] == ' ' && c[1] == ':' && c[2] == ' ') {
+      return c;
+    }
+  }
+  return _end;
+}
+
+// this extracts the value of 'key=value' from a space separated list
+bool findValue(const char* _begin, const char* _end, const char* _key,
+               u64* _value) {
+  u64 len = strlen(_key);
+  const char* c = _begin;
+  while (c < _end) {
+    while (c < _end && *c == ' ') {
+      c++;
+    }
+    if ((u64)(_end - c) > len && memcmp(c, _key, len) == 0 &&
+        c[len] == '=') {
+      *_value = strtoull(c + len + 1, nullptr, 10);
+      return true;
+    }
+    while (c < _end && *c != ' ') {
+      c++;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+LogAnalyzer::LogAnalyzer(const std::string& _filename, u32 _numThreads)
+    : filename_(_filename), numThreads_(_numThreads), phaseStats_(nullptr),
+      lastTick_(0), done_(false), lastStop_(0), nextChunk_(0),
+      pruned_(false) {
+  // gzip reads plain files transparently
+  file_ = gzopen(filename_.c_str(), "rb");
+  if (file_ == nullptr) {
+    fprintf(stderr, "couldn't open log file: %s\n", filename_.c_str());
+    exit(-1);
+  }
+  gzbuffer(file_, 1024 * 1024);
+}
+
+LogAnalyzer::~LogAnalyzer() {
+  gzclose(file_);
+  delete phaseStats_;
+}
+
+std::string LogAnalyzer::run() {
+  readSettings();
+
+  std::vector<std::thread> workers;
+  for (u32 t = 0; t < numThreads_; t++) {
+    workers.push_back(std::thread(&LogAnalyzer::worker, this));
+  }
+
+  // read chunks of whole lines and queue them for the workers
+  std::string carry;
+  u64 index = 0;
+  while (true) {
+    std::string* chunk = new std::string(carry);
+    u64 have = chunk->size();
+    chunk->resize(have + CHUNK_SIZE);
+    s32 bytes = gzread(file_, &(*chunk)[have], CHUNK_SIZE);
+    if (bytes < 0) {
+      fprintf(stderr, "couldn't read log file: %s\n", filename_.c_str());
+      exit(-1);
+    }
+    chunk->resize(have + bytes);
+
+    bool last = bytes == 0;
+    if (!last) {
+      u64 newline = chunk->rfind('\n');
+      if (newline == std::string::npos) {
+        // no complete line yet
+        carry.swap(*chunk);
+        delete chunk;
+        continue;
+      }
+      carry.assign(*chunk, newline + 1, std::string::npos);
+      chunk->resize(newline + 1);
+    }
+
+    {
+      std::unique_lock<std::mutex> guard(queueLock_);
+      queueNotFull_.wait(guard, [this] {
+          return queue_.size() < 2 * numThreads_; });
+      queue_.push_back({index++, chunk});
+    }
+    queueNotEmpty_.notify_one();
+
+    if (last) {
+      break;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(queueLock_);
+    done_ = true;
+  }
+  queueNotEmpty_.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  // transactions still outstanding never reached a receiver
+  if (lastTick_ > 0) {
+    phaseStats_->setLastTick(lastTick_);
+  }
+  return phaseStats_->toString();
+}
+
+void LogAnalyzer::readSettings() {
+  // the log starts with the configuration, ending with a closing brace line
+  std::string conf;
+  char buf[4096];
+  bool lineStart = true;
+  while (gzgets(file_, buf, sizeof(buf)) != nullptr) {
+    if (lineStart && conf.empty() && buf[0] != '{') {
+      break;
+    }
+    conf += buf;
+    u64 len = strlen(buf);
+    bool lineEnd = len > 0 && buf[len - 1] == '\n';
+    if (lineStart && lineEnd && strcmp(buf, "}\n") == 0) {
+      break;
+    }
+    lineStart = lineEnd;
+  }
+
+  Json::Value settings;
+  Json::Reader reader;
+  if (conf.empty() || !reader.parse(conf, settings)) {
+    fprintf(stderr, "log file doesn't start with the configuration "
+            "(run with verbosity > 1): %s\n", filename_.c_str());
+    exit(-1);
+  }
+
+  std::vector<des::Tick> schedule;
+  for (const Json::Value& rateChange : settings["sender_control"]) {
+    schedule.push_back(rateChange[0].asUInt64());
+  }
+  phaseStats_ = new PhaseStats(schedule);
+  lastStop_ = phaseStats_->lastStop();
+}
+
+void LogAnalyzer::worker() {
+  Events events;
+  while (true) {
+    Chunk chunk;
+    {
+      std::unique_lock<std::mutex> guard(queueLock_);
+      queueNotEmpty_.wait(guard, [this] { return done_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      chunk = queue_.front();
+      queue_.pop_front();
+    }
+    queueNotFull_.notify_one();
+
+    events.creates.clear();
+    events.ends.clear();
+    events.totalTicks = 0;
+    events.index = chunk.index;
+    events.lastTick = 0;
+    parse(chunk.text->data(), chunk.text->data() + chunk.text->size(),
+          &events);
+    delete chunk.text;
+    merge(events);
+  }
+}
+
+void LogAnalyzer::parse(const char* _begin, const char* _end,
+                        Events* _events) {
+  while (_begin < _end) {
+    const char* eol = reinterpret_cast<const char*>(
+        memchr(_begin, '\n', _end - _begin));
+    if (eol == nullptr) {
+      eol = _end;
+    }
+    parseLine(_begin, eol, _events);
+    _begin = eol + 1;
+  }
+}
+
+void LogAnalyzer::parseLine(const char* _begin, const char* _end,
+                            Events* _events) {
+  // stats lines follow the data
+  if (_begin == _end || _begin[0] != '[') {
+    if (startsWith(_begin, _end, TOTAL_TICKS)) {
+      _events->totalTicks = strtoull(_begin + sizeof(TOTAL_TICKS) - 1,
+                                     nullptr, 10);
+    }
+    return;
+  }
+
+  // format: [tick:epsilon] name : func : | key=value ...
+  u64 tick = strtoull(_begin + 1, nullptr, 10);
+  _events->lastTick = tick;
+  const char* name = reinterpret_cast<const char*>(
+      memchr(_begin, ']', _end - _begin));
+  if (name == nullptr) {
+    return;
+  }
+  name += 2;
+  const char* nameEnd = findSeparator(name, _end);
+  if (nameEnd == _end) {
+    return;
+  }
+  const char* func = nameEnd + 3;
+  const char* funcEnd = findSeparator(func, _end);
+  if (funcEnd == _end) {
+    return;
+  }
+  const char* msg = funcEnd + 3;
+  if (msg < _end && *msg == '|') {
+    msg++;
+  }
+
+  u64 trans = 0;
+  u64 size = 0;
+  if (startsWith(func, funcEnd, "handle_recv") &&
+      funcEnd - func == sizeof("handle_recv") - 1) {
+    if (!findValue(msg, _end, "size", &size) ||
+        !findValue(msg, _end, "trans", &trans)) {
+      return;
+    }
+    if (startsWith(name, nameEnd, "Receiver")) {
+      if (trans != 0) {
+        _events->ends.push_back({trans, tick});
+      }
+    } else if (size > 0) {
+      // everything not received by a receiver is overhead
+      phaseStats_->recordOverhead(tick, size);
+    }
+  } else if (startsWith(func, funcEnd, "handle_sendMessage") &&
+             funcEnd - func == sizeof("handle_sendMessage") - 1) {
+    if (findValue(msg, _end, "trans", &trans) && trans != 0 &&
+        findValue(msg, _end, "size", &size)) {
+      _events->creates.push_back({trans, tick, (u32)size});
+    }
+  }
+}
+
+void LogAnalyzer::merge(const Events& _events) {
+  std::lock_guard<std::mutex> guard(mergeLock_);
+  if (_events.totalTicks > 0) {
+    lastTick_ = _events.totalTicks;
+  }
+
+  // chunks are merged out of order so either end may be seen first. a
+  //  transaction ending after the last section isn't recorded, thus neither
+  //  is one created after it
+  for (const Events::Create& create : _events.creates) {
+    if (create.tick > lastStop_) {
+      continue;
+    }
+    Transaction& t = transactions_[create.trans];
+    t.create = create.tick;
+    t.size = create.size;
+    t.created = true;
+    if (t.ended) {
+      phaseStats_->recordLatency(t.end, t.end - t.create - t.size);
+      transactions_.erase(create.trans);
+    }
+  }
+  for (const Events::End& end : _events.ends) {
+    if (end.tick > lastStop_) {
+      continue;
+    }
+    auto it = transactions_.find(end.trans);
+    if (it == transactions_.end()) {
+      Transaction& t = transactions_[end.trans];
+      t.end = end.tick;
+      t.created = false;
+      t.ended = true;
+    } else {
+      Transaction& t = it->second;
+      assert(t.created);
+      phaseStats_->recordLatency(end.tick, end.tick - t.create - t.size);
+      transactions_.erase(it);
+    }
+  }
+
+  // once all chunks up to the end of the last section were merged, the
+  //  remaining transactions can only end after it
+  mergedChunks_[_events.index] = _events.lastTick;
+  while (!mergedChunks_.empty() &&
+         mergedChunks_.begin()->first == nextChunk_) {
+    if (!pruned_ && mergedChunks_.begin()->second > lastStop_) {
+      transactions_.clear();
+      pruned_ = true;
+    }
+    mergedChunks_.erase(mergedChunks_.begin());
+    nextChunk_++;
+  }
+}
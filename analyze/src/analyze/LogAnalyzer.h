@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ANALYZE_LOGANALYZER_H_
+#define ANALYZE_LOGANALYZER_H_
+
+#include <prim/prim.h>
+#include <zlib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ratecontrol/PhaseStats.h"
+
+/*
+ * This computes the section statistics of parser/parser.py from a ratesim
+ *  log (plain or gzip compressed) in a single streaming pass. The reading
+ *  thread hands fixed size chunks of whole lines to worker threads, which
+ *  parse them and record into a PhaseStats. The log is in tick order.
+ *  Transactions created or received after the last section can't be
+ *  recorded, so they are skipped, and the ones still unmatched are pruned
+ *  once every chunk up to the end of the last section was merged. Memory is
+ *  thus bounded by the chunks in flight plus the transactions outstanding
+ *  within the sections, independent of the length of the log.
+ */
+class LogAnalyzer {
+ public:
+  LogAnalyzer(const std::string& _filename, u32 _numThreads);
+  ~LogAnalyzer();
+
+  /*
+   * This runs the analysis and returns the statistics.
+   */
+  std::string run();
+
+  static const u64 CHUNK_SIZE = 4 * 1024 * 1024;
+
+ private:
+  // this holds either end of a transaction until both are seen
+  struct Transaction {
+    u64 create;
+    u64 end;
+    u32 size;
+    bool created;
+    bool ended;
+  };
+
+  // this is a chunk of whole lines, numbered in log order
+  struct Chunk {
+    u64 index;
+    std::string* text;
+  };
+
+  // these are the transaction events of one chunk
+  struct Events {
+    struct Create {
+      u64 trans;
+      u64 tick;
+      u32 size;
+    };
+    struct End {
+      u64 trans;
+      u64 tick;
+    };
+    std::vector<Create> creates;
+    std::vector<End> ends;
+    u64 totalTicks;  // 0 when not in this chunk
+    u64 index;  // of the chunk
+    u64 lastTick;  // of the last data line, 0 when there is none
+  };
+
+  void readSettings();
+  void worker();
+  void parse(const char* _begin, const char* _end, Events* _events);
+  void parseLine(const char* _begin, const char* _end, Events* _events);
+  void merge(const Events& _events);
+
+  const std::string filename_;
+  const u32 numThreads_;
+  gzFile file_;
+  PhaseStats* phaseStats_;
+  u64 lastTick_;
+
+  // the chunk queue
+  std::mutex queueLock_;
+  std::condition_variable queueNotEmpty_;
+  std::condition_variable queueNotFull_;
+  std::deque<Chunk> queue_;
+  bool done_;
+
+  // the outstanding transactions
+  std::mutex mergeLock_;
+  std::unordered_map<u64, Transaction> transactions_;
+  des::Tick lastStop_;  // the end of the last section
+  u64 nextChunk_;  // the first chunk not merged yet
+  std::map<u64, u64> mergedChunks_;  // last ticks of later merged chunks
+  bool pruned_;
+};
+
+#endif  // ANALYZE_LOGANALYZER_H_
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <prim/prim.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+#include <thread>
+
+#include "analyze/LogAnalyzer.h"
+
+void usage(const char* _program) {
+  fprintf(stderr, "usage: %s [-t threads] <log file> [stats file]\n",
+          _program);
+  exit(-1);
+}
+
+s32 main(s32 _argc, char** _argv) {
+  u32 numThreads = std::thread::hardware_concurrency();
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
+
+  // parse the arguments
+  s32 arg = 1;
+  if (arg < _argc && strcmp(_argv[arg], "-t") == 0) {
+    if (arg + 1 >= _argc) {
+      usage(_argv[0]);
+    }
+    numThreads = (u32)atoi(_argv[arg + 1]);
+    if (numThreads < 1) {
+      fprintf(stderr, "there must be at least one thread\n");
+      exit(-1);
+    }
+    arg += 2;
+  }
+  if (arg >= _argc || _argc - arg > 2) {
+    usage(_argv[0]);
+  }
+  std::string logFile = _argv[arg];
+  std::string statsFile = arg + 1 < _argc ? _argv[arg + 1] : "";
+
+  // analyze the log
+  LogAnalyzer analyzer(logFile, numThreads);
+  std::string stats = analyzer.run();
+
+  // write the statistics
+  FILE* fp = statsFile.empty() ? stdout : fopen(statsFile.c_str(), "w");
+  if (fp == nullptr) {
+    fprintf(stderr, "couldn't open stats file: %s\n", statsFile.c_str());
+    exit(-1);
+  }
+  fwrite(stats.c_str(), 1, stats.size(), fp);
+  if (fp != stdout) {
+    fclose(fp);
+  }
+
+  return 0;
+}
@@ -0,0 +1 @@
+../../../src/ratecontrol/Histogram.cc
\ No newline at end of file
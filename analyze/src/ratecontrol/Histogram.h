@@ -0,0 +1 @@
+../../../src/ratecontrol/Histogram.h
\ No newline at end of file
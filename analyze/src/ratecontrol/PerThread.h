@@ -0,0 +1 @@
+../../../src/ratecontrol/PerThread.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/PerThread.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/PhaseStats.h
\ No newline at end of file
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# the timing metrics are only comparable on the host the baseline was recorded
+HOST = '{0} {1} {2}cpu'.format(platform.node(), platform.machine(),
+                               os.cpu_count())
+
+BENCH = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(BENCH)
+
+CONFIGS = ['basic', 'relay', 'dist1', 'dist2', 'dist3', 'dist4']
+
+# the node counts and rate limit of the shipped configs are multiplied by the
+#  scale, the traffic pattern keeps its shape and duration
+SCALES = {
+  'small': 0.02,
+  'medium': 0.2,
+  'large': 1.0
+}
+
+# the metrics, whether higher values are better, and the default tolerance as
+#  the relative change allowed in the worse direction
+METRICS = {
+  'wall_seconds': {'higher': False, 'tolerance': 0.25},
+  'events': {'higher': False, 'tolerance': 0.0},
+  'events_per_second': {'higher': True, 'tolerance': 0.25},
+  'peak_rss_mb': {'higher': False, 'tolerance': 0.10},
+  'ticks_per_second': {'higher': True, 'tolerance': 0.25}
+}
+
+
+def scaleTraffic(src, dst, scale):
+  # rewrite the sender ranges (i.e. "1-500=0.8") for the scaled senders, the
+  #  file isn't strict json (leading zeros) so it is edited as text
+  def scaleRange(match):
+    start = int((int(match.group(1)) - 1) * scale) + 1
+    stop = max(start, int(int(match.group(2)) * scale))
+    return '{0}-{1}='.format(start, stop)
+  with open(src, 'r') as fd:
+    text = fd.read()
+  with open(dst, 'w') as fd:
+    fd.write(re.sub(r'(\d+)-(\d+)=', scaleRange, text))
+
+
+def run(binary, workdir, config, scale, seed):
+  # count the nodes of the shipped config (the files may have comments, so
+  #  only pick out the needed fields)
+  with open(os.path.join(workdir, config + '.json'), 'r') as fd:
+    text = fd.read()
+  def field(name):
+    return float(re.search('"{0}": ([0-9.]+)'.format(name), text).group(1))
+
+  log = os.path.join(workdir, config + '.log')
+  cmd = [
+    binary, os.path.join(workdir, config + '.json'),
+    'senders=uint={0}'.format(int(field('senders') * scale)),
+    'receivers=uint={0}'.format(max(1, int(field('receivers') * scale))),
+    'relays=uint={0}'.format(int(field('relays') * scale)),
+    'rate_limit=float={0}'.format(field('rate_limit') * scale),
+    'seed=uint={0}'.format(seed),
+    'threads=uint=1',
+    'verbosity=uint=1',
+    'log_file=string={0}'.format(log)]
+
+  # run and take the resource usage of this child only
+  start = time.time()
+  proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL)
+  _, status, usage = os.wait4(proc.pid, 0)
+  wall = time.time() - start
+  if status != 0:
+    print('failed: {0}'.format(' '.join(cmd)), file=sys.stderr)
+    sys.exit(-1)
+
+  # pull the run stats out of the log
+  stats = {}
+  with open(log, 'r') as fd:
+    for line in fd:
+      for key, name in [('Total event count:', 'events'),
+                        ('Total simulation ticks:', 'ticks'),
+                        ('Real elapsed seconds:', 'seconds')]:
+        if line.startswith(key):
+          stats[name] = float(line[len(key):])
+  os.remove(log)
+
+  return {
+    'wall_seconds': wall,
+    'events': int(stats['events']),
+    'events_per_second': stats['events'] / stats['seconds'],
+    'peak_rss_mb': usage.ru_maxrss / 1024.0,
+    'ticks_per_second': stats['ticks'] / stats['seconds']
+  }
+
+
+def best(results):
+  # the best value of each metric over repeated runs, this filters out the
+  #  noise of other load on the machine
+  combined = {}
+  for metric, info in METRICS.items():
+    values = [result[metric] for result in results]
+    combined[metric] = max(values) if info['higher'] else min(values)
+  return combined
+
+
+def compare(name, result, baseline, tolerances):
+  # returns the list of regressed metrics
+  regressions = []
+  for metric, info in sorted(METRICS.items()):
+    value = result[metric]
+    base = baseline[metric]
+    tolerance = tolerances.get(metric, info['tolerance'])
+    change = (value - base) / base if base != 0 else 0.0
+    worse = -change if info['higher'] else change
+    regressed = worse > tolerance
+    if regressed:
+      regressions.append(metric)
+    print('  {0:<18} {1:>14.2f} {2:>14.2f} {3:>+8.1f}% {4}'.format(
+      metric, base, value, change * 100.0, 'REGRESSED' if regressed else ''))
+  return regressions
+
+
+def main(args):
+  binary = os.path.abspath(args.binary)
+  if not os.path.isfile(binary):
+    print('binary not found: {0}'.format(binary), file=sys.stderr)
+    return -1
+
+  # without a baseline nothing can be compared, only recording one is allowed
+  baseline = {'tolerances': {}, 'results': {}}
+  if os.path.isfile(args.baseline):
+    with open(args.baseline, 'r') as fd:
+      baseline = json.load(fd)
+  elif not args.update:
+    print('baseline not found: {0} (record one with --update)'.format(
+      args.baseline), file=sys.stderr)
+    return -1
+
+  if not args.update and baseline.get('host', HOST) != HOST:
+    print('warning: the baseline was recorded on {0}'.format(baseline['host']),
+          file=sys.stderr)
+
+  # results are only comparable with the seed of the baseline
+  seed = args.seed
+  if seed is None:
+    seed = baseline.get('seed', 12345)
+  elif not args.update and seed != baseline.get('seed', seed):
+    print('seed differs from the baseline seed', file=sys.stderr)
+    return -1
+
+  # run each config at each scale in a private copy of the json directory
+  results = {}
+  failed = []
+  missing = []
+  for scale in args.scales:
+    workdir = tempfile.mkdtemp(prefix='ratesim_regress_')
+    try:
+      for filename in os.listdir(os.path.join(ROOT, 'json')):
+        shutil.copy(os.path.join(ROOT, 'json', filename), workdir)
+      scaleTraffic(os.path.join(ROOT, 'json', 'traffic.json'),
+                   os.path.join(workdir, 'traffic.json'), SCALES[scale])
+      for config in args.configs:
+        name = '{0}/{1}'.format(config, scale)
+        print(name)
+        result = best([run(binary, workdir, config, SCALES[scale], seed)
+                       for _ in range(args.repeats)])
+        results[name] = result
+        if args.update:
+          continue
+        if name not in baseline['results']:
+          print('  no baseline')
+          missing.append(name)
+          continue
+        regressions = compare(name, result, baseline['results'][name],
+                              baseline['tolerances'])
+        if regressions:
+          failed.append(name)
+    finally:
+      shutil.rmtree(workdir)
+
+  if args.update:
+    baseline['seed'] = seed
+    baseline['host'] = HOST
+    if not baseline['tolerances']:
+      baseline['tolerances'] = {
+        metric: info['tolerance'] for metric, info in METRICS.items()}
+    baseline['results'].update(results)
+    with open(args.baseline, 'w') as fd:
+      json.dump(baseline, fd, indent=2, sort_keys=True)
+      fd.write('\n')
+    print('updated {0}'.format(args.baseline))
+    return 0
+
+  if missing:
+    print('missing baselines: {0}'.format(' '.join(missing)))
+  if failed:
+    print('regressions: {0}'.format(' '.join(failed)))
+  if missing or failed:
+    return 1
+  print('no regressions')
+  return 0
+
+
+if __name__ == '__main__':
+  ap = argparse.ArgumentParser(
+    description='runs the shipped configs at fixed scales and seed and '
+    'compares the run metrics against a recorded baseline, the exit code is 1 '
+    'when any metric is worse than its tolerance or a scenario has no '
+    'baseline')
+  ap.add_argument('-b', '--binary',
+                  default=os.path.join(ROOT, 'bin', 'ratesim'),
+                  help='the simulator to run')
+  ap.add_argument('-f', '--baseline',
+                  default=os.path.join(BENCH, 'baseline.json'),
+                  help='the baseline file')
+  ap.add_argument('-c', '--configs', nargs='+', default=CONFIGS,
+                  choices=CONFIGS, help='the configs to run')
+  ap.add_argument('-s', '--scales', nargs='+',
+                  default=['small', 'medium', 'large'],
+                  choices=sorted(SCALES.keys()), help='the scales to run')
+  ap.add_argument('-r', '--repeats', type=int, default=3,
+                  help='the runs of each scenario, the best is kept')
+  ap.add_argument('--seed', type=int, default=None,
+                  help='the simulation seed (default: the baseline seed)')
+  ap.add_argument('-u', '--update', action='store_true',
+                  help='record the results as the new baseline')
+  sys.exit(main(ap.parse_args()))
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench/Benchmark.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include <atomic>
+#include <limits>
+#include <new>
+
+namespace {
+std::atomic<u64> allocCount(0);
+}  // namespace
+
+void* operator new(size_t _size) {
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(_size == 0 ? 1 : _size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t _size) {
+  return operator new(_size);
+}
+
+void operator delete(void* _ptr) noexcept {
+  free(_ptr);
+}
+
+void operator delete[](void* _ptr) noexcept {
+  free(_ptr);
+}
+
+u64 allocations() {
+  return allocCount.load(std::memory_order_relaxed);
+}
+
+Measurement::Measurement()
+    : startAllocs_(0), ops_(0), seconds_(0.0), allocs_(0),
+      allocsKnown_(true) {}
+
+Measurement::~Measurement() {}
+
+void Measurement::start() {
+  startAllocs_ = allocations();
+  startTime_ = std::chrono::steady_clock::now();
+}
+
+void Measurement::stop(u64 _ops) {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  allocs_ = allocations() - startAllocs_;
+  seconds_ = std::chrono::duration<f64>(now - startTime_).count();
+  assert(_ops > 0);
+  ops_ = _ops;
+}
+
+void Measurement::record(u64 _ops, f64 _seconds) {
+  assert(_ops > 0);
+  ops_ = _ops;
+  seconds_ = _seconds;
+  allocs_ = 0;
+  allocsKnown_ = false;
+}
+
+u64 Measurement::ops() const {
+  return ops_;
+}
+
+f64 Measurement::nsPerOp() const {
+  return seconds_ * 1e9 / ops_;
+}
+
+f64 Measurement::allocsPerOp() const {
+  if (!allocsKnown_) {
+    return std::numeric_limits<f64>::quiet_NaN();
+  }
+  return (f64)allocs_ / ops_;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCH_BENCHMARK_H_
+#define BENCH_BENCHMARK_H_
+
+#include <prim/prim.h>
+
+#include <chrono>
+#include <string>
+
+/*
+ * This returns the number of heap allocations made so far by this program.
+ *  The global operator new is replaced to count them.
+ */
+u64 allocations();
+
+/*
+ * This measures the wall time and heap allocations of the operations done
+ *  between start() and stop(). Setup and teardown stay outside of it.
+ */
+class Measurement {
+ public:
+  Measurement();
+  ~Measurement();
+
+  void start();
+  void stop(u64 _ops);
+
+  /*
+   * This records operations timed elsewhere (i.e. by the profiler). Their
+   *  allocations aren't known, so allocsPerOp() returns NaN.
+   */
+  void record(u64 _ops, f64 _seconds);
+
+  u64 ops() const;
+  f64 nsPerOp() const;
+  f64 allocsPerOp() const;
+
+ private:
+  std::chrono::steady_clock::time_point startTime_;
+  u64 startAllocs_;
+  u64 ops_;
+  f64 seconds_;
+  u64 allocs_;
+  bool allocsKnown_;
+};
+
+/*
+ * This is a benchmark of one hot path. 'func' sets up a case of the given
+ *  size and measures its operations.
+ */
+struct Benchmark {
+  const char* name;
+  u64 sizes[4];  // 0 terminates the list early
+  void (*func)(u64 _size, Measurement* _measurement);
+};
+
+#endif  // BENCH_BENCHMARK_H_
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "bench/HotPaths.h"
+
+#include <des/des.h>
+#include <jsoncpp/json/json.h>
+
+#include <cassert>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ratecontrol/DistSender.h"
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Network.h"
+#include "ratecontrol/Node.h"
+#include "ratecontrol/Profiler.h"
+#include "ratecontrol/QueuedNode.h"
+#include "ratecontrol/Queuing.h"
+#include "ratecontrol/RateSchedule.h"
+#include "ratecontrol/Relay.h"
+#include "ratecontrol/SenderConfig.h"
+#include "ratecontrol/SenderControl.h"
+
+namespace {
+const des::Tick NETWORK_DELAY = 10;
+
+// this is a node that runs a function at tick 0 and drops what it receives
+class BenchNode : public QueuedNode<BenchNode, FifoQueuing> {
+ public:
+  typedef std::function<void(BenchNode*)> Start;
+
+  BenchNode(des::Simulator* _sim, u32 _id, Network* _network)
+      : QueuedNode(_sim, "BenchNode", nullptr, _id, _network), received(0) {
+    seed(_id);
+  }
+
+  void onStart(const Start& _start) {
+    start_ = _start;
+    simulator->addEvent(new des::Event(
+        this, static_cast<des::EventHandler>(&BenchNode::handle_start),
+        des::Time(0)));
+  }
+
+  void recv(Message* _msg) {
+    received++;
+    delete _msg;
+  }
+
+  void transmit(Message* _msg) {
+    send(_msg);
+  }
+
+  u64 cycles(u32 _size, f64 _rate) {
+    return cyclesToSend(_size, _rate);
+  }
+
+  u64 received;
+
+ private:
+  void handle_start(des::Event* _event) {
+    delete _event;
+    start_(this);
+  }
+
+  Start start_;
+};
+
+// this stands in for a range of receivers and counts what they receive
+class BenchSink : public Node {
+ public:
+  BenchSink(des::Simulator* _sim, u32 _firstId, u32 _count, Network* _network)
+      : Node(_sim, "BenchSink", nullptr, _firstId, _network,
+             static_cast<des::EventHandler>(&BenchSink::handle_recv)),
+        received(0) {
+    network_->registerRange(id + 1, _count - 1, this);
+  }
+
+  u64 received;
+
+ private:
+  void handle_recv(des::Event* _event) {
+    MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
+    received++;
+    delete evt->msg;
+    delete evt;
+  }
+};
+
+// this is a sender which only takes the rate changes
+class BenchSender {
+ public:
+  BenchSender() : starts(0) {}
+
+  void setRateSchedule(const RateSchedule* _schedule, u32 _index) {
+    (void)_schedule;  // unused
+    (void)_index;  // unused
+  }
+
+  void startInjection(u32 _index, des::Time _time) {
+    (void)_index;  // unused
+    (void)_time;  // unused
+    starts++;
+  }
+
+  u64 starts;
+};
+
+// this creates a schedule alternating between the two halves of '_senders'
+Json::Value alternatingSchedule(u64 _changes, u32 _senders) {
+  u32 half = _senders / 2;
+  std::string first = "1-" + std::to_string(half);
+  std::string second = std::to_string(half + 1) + "-" +
+      std::to_string(_senders);
+  Json::Value schedule(Json::arrayValue);
+  for (u64 idx = 0; idx < _changes; idx++) {
+    bool even = idx % 2 == 0;
+    Json::Value change(Json::arrayValue);
+    change.append(Json::Value::UInt64(idx * 10));
+    change.append(first + (even ? "=0.5:" : "=0.0:") + second +
+                  (even ? "=0.0" : "=0.5"));
+    schedule.append(change);
+  }
+  return schedule;
+}
+
+// this simulates '_senders' dist senders offered twice the rate limit, so
+//  they run short of tokens and steal. the calls and the self time of the
+//  profiler site '_site' (e.g. "processQueue") are recorded. the self time
+//  excludes nested sites, so processSteal() isn't counted in processQueue()
+void runDistSenders(u32 _senders, const std::string& _site,
+                    Measurement* _measurement) {
+  const u32 RECEIVERS = 10;
+  const des::Tick DURATION = 10000;
+  const f64 RATE_LIMIT = 10.0;
+  assert(_senders > 1);
+  f64 rate = std::min(0.5, 2 * RATE_LIMIT / _senders);
+
+  Json::Value settings;
+  settings["algorithm"] = "dist";
+  settings["senders"] = _senders;
+  settings["min_message_size"] = 5;
+  settings["max_message_size"] = 80;
+  Json::Value& config = settings["sender_config"];
+  config["steal_tokens"] = true;
+  config["steal_rate"] = true;
+  config["params"]["max_tokens"] = 500;
+  config["params"]["steal_threshold"] = 0.2;
+  config["params"]["token_ask_factor"] = 1.0;
+  config["params"]["rate_ask_factor"] = 1.0;
+  config["params"]["max_requests_outstanding"] = std::min(10u, _senders - 1);
+  config["params"]["give_token_threshold"] = 0.4;
+  config["params"]["give_rate_threshold"] = 0.9;
+  config["params"]["give_rate_factor"] = 0.9;
+  SenderConfig senderConfig(settings);
+
+  Json::Value schedule(Json::arrayValue);
+  schedule[0][0] = 0;
+  schedule[0][1] = "*=" + std::to_string(rate);
+  schedule[1][0] = Json::Value::UInt64(DURATION);
+  schedule[1][1] = "*=0.0";
+
+  des::Simulator sim(1);
+  Network network(&sim, "Network", nullptr, NETWORK_DELAY);
+  network.reserve(RECEIVERS + _senders);
+  BenchSink sink(&sim, 0, RECEIVERS, &network);
+  std::vector<DistSender<FifoQueuing>*> senders(_senders);
+  for (u32 s = 0; s < _senders; s++) {
+    senders[s] = new DistSender<FifoQueuing>(
+        &sim, "DistSender", nullptr, RECEIVERS + s, &network, 5, 80, 0,
+        RECEIVERS - 1, RATE_LIMIT, &senderConfig);
+    senders[s]->seed(1);
+  }
+  for (DistSender<FifoQueuing>* sender : senders) {
+    sender->distIds(RECEIVERS, RECEIVERS + _senders - 1);
+  }
+  SenderControl<DistSender<FifoQueuing> > control(
+      &sim, "SenderControl", nullptr, &senders, schedule);
+
+  Profiler::reset();
+  Profiler::enable();
+  sim.simulate(false);
+  Profiler::disable();
+  std::string name = "DistSender<FifoQueuing>." + _site;
+  _measurement->record(std::max(Profiler::calls(name), (u64)1),
+                       Profiler::seconds(name));
+  assert(sink.received > 0);
+
+  for (DistSender<FifoQueuing>* sender : senders) {
+    delete sender;
+  }
+}
+
+}  // namespace
+
+void benchNodeSend(u64 _size, Measurement* _measurement) {
+  des::Simulator sim(1);
+  Network network(&sim, "Network", nullptr, NETWORK_DELAY);
+  network.reserve(2);
+  BenchNode src(&sim, 0, &network);
+  BenchNode dst(&sim, 1, &network);
+  src.onStart([&](BenchNode* _node) {
+      for (u64 idx = 0; idx < _size; idx++) {
+        _node->transmit(new Message(0, 1, 1 + idx % 80, idx, Message::PLAIN,
+                                    0));
+      }
+    });
+
+  _measurement->start();
+  sim.simulate(false);
+  _measurement->stop(_size);
+  assert(dst.received == _size);
+}
+
+void benchCyclesToSend(u64 _size, Measurement* _measurement) {
+  des::Simulator sim(1);
+  Network network(&sim, "Network", nullptr, NETWORK_DELAY);
+  BenchNode node(&sim, 0, &network);
+
+  _measurement->start();
+  u64 sum = 0;
+  for (u64 idx = 0; idx < _size; idx++) {
+    sum += node.cycles(1 + idx % 80, 0.37);
+  }
+  _measurement->stop(_size);
+  volatile u64 sink = sum;  // keep the loop
+  (void)sink;
+}
+
+void benchRelayRecv(u64 _size, Measurement* _measurement) {
+  des::Simulator sim(1);
+  Network network(&sim, "Network", nullptr, NETWORK_DELAY);
+  network.reserve(3);
+  BenchNode src(&sim, 0, &network);
+  Relay<FifoQueuing> relay(&sim, "Relay", nullptr, 1, &network, 1.0);
+  BenchNode dst(&sim, 2, &network);
+  src.onStart([&](BenchNode* _node) {
+      (void)_node;  // unused
+      for (u64 idx = 0; idx < _size; idx++) {
+        Message* msg = new Message(0, 1, 2 + idx % 80, idx,
+                                   Message::RELAY_REQUEST, 0);
+        msg->relayRequest()->reqId = idx;
+        msg->relayRequest()->msgDst = 2;
+        relay.recv(msg);
+      }
+    });
+
+  _measurement->start();
+  sim.simulate(false);
+  _measurement->stop(_size);
+  assert(src.received == _size && dst.received == _size);
+}
+
+void benchDistSenderQueue(u64 _size, Measurement* _measurement) {
+  runDistSenders(_size + 1, "processQueue", _measurement);
+}
+
+void benchDistSenderSteal(u64 _size, Measurement* _measurement) {
+  runDistSenders(_size + 1, "processSteal", _measurement);
+}
+
+void benchSenderControlBuild(u64 _size, Measurement* _measurement) {
+  const u32 SENDERS = 1000;
+  Json::Value schedule = alternatingSchedule(_size, SENDERS);
+  des::Simulator sim(1);
+  std::vector<BenchSender> benchSenders(SENDERS);
+  std::vector<BenchSender*> senders;
+  for (BenchSender& sender : benchSenders) {
+    senders.push_back(&sender);
+  }
+
+  _measurement->start();
+  SenderControl<BenchSender>* control = new SenderControl<BenchSender>(
+      &sim, "SenderControl", nullptr, &senders, schedule);
+  _measurement->stop(_size);
+
+  // process the events of the schedule
+  sim.simulate(false);
+  delete control;
+}
+
+void benchSenderControlRun(u64 _size, Measurement* _measurement) {
+  const u32 SENDERS = 1000;
+  Json::Value schedule = alternatingSchedule(_size, SENDERS);
+  des::Simulator sim(1);
+  std::vector<BenchSender> benchSenders(SENDERS);
+  std::vector<BenchSender*> senders;
+  for (BenchSender& sender : benchSenders) {
+    senders.push_back(&sender);
+  }
+  SenderControl<BenchSender> control(&sim, "SenderControl", nullptr,
+                                     &senders, schedule);
+
+  _measurement->start();
+  sim.simulate(false);
+  _measurement->stop(_size);
+  assert(benchSenders[0].starts == (_size + 1) / 2);
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCH_HOTPATHS_H_
+#define BENCH_HOTPATHS_H_
+
+#include <prim/prim.h>
+
+#include "bench/Benchmark.h"
+
+/*
+ * These measure the hot paths of the simulator. '_size' is the number of
+ *  operations unless noted otherwise.
+ */
+
+// messages sent from one node to another: send, enqueue, transmit and recv
+void benchNodeSend(u64 _size, Measurement* _measurement);
+
+// Node::cyclesToSend() calls
+void benchCyclesToSend(u64 _size, Measurement* _measurement);
+
+// relay requests received by a relay, forwarded and answered
+void benchRelayRecv(u64 _size, Measurement* _measurement);
+
+// DistSender::processQueue() and processSteal() calls, each timed by the
+//  profiler without its nested sites, of dist senders that are short of
+//  tokens and steal from '_size' peers each
+void benchDistSenderQueue(u64 _size, Measurement* _measurement);
+void benchDistSenderSteal(u64 _size, Measurement* _measurement);
+
+// the parsing of a schedule with '_size' rate changes by SenderControl
+void benchSenderControlBuild(u64 _size, Measurement* _measurement);
+
+// the rate changes applied by SenderControl, '_size' of them
+void benchSenderControlRun(u64 _size, Measurement* _measurement);
+
+#endif  // BENCH_HOTPATHS_H_
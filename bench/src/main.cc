@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <prim/prim.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench/Benchmark.h"
+#include "bench/HotPaths.h"
+
+void usage(const char* _program) {
+  fprintf(stderr, "usage: %s [name filter]\n", _program);
+  exit(-1);
+}
+
+s32 main(s32 _argc, char** _argv) {
+  const Benchmark BENCHMARKS[] = {
+    {"node_send", {10000, 100000, 1000000, 0}, benchNodeSend},
+    {"cycles_to_send", {10000000, 0, 0, 0}, benchCyclesToSend},
+    {"relay_recv", {10000, 100000, 1000000, 0}, benchRelayRecv},
+    {"dist_sender_queue", {100, 1000, 10000, 100000}, benchDistSenderQueue},
+    {"dist_sender_steal", {100, 1000, 10000, 100000}, benchDistSenderSteal},
+    {"sender_control_build", {1000, 10000, 0, 0}, benchSenderControlBuild},
+    {"sender_control_run", {1000, 10000, 0, 0}, benchSenderControlRun}
+  };
+
+  // parse the arguments
+  if (_argc > 2) {
+    usage(_argv[0]);
+  }
+  const char* filter = _argc == 2 ? _argv[1] : "";
+
+  // run all benchmarks whose name contains the filter
+  printf("%-22s %10s %12s %12s %12s\n", "benchmark", "size", "ops", "ns/op",
+         "allocs/op");
+  for (const Benchmark& benchmark : BENCHMARKS) {
+    if (strstr(benchmark.name, filter) == nullptr) {
+      continue;
+    }
+    for (u64 size : benchmark.sizes) {
+      if (size == 0) {
+        break;
+      }
+      Measurement measurement;
+      benchmark.func(size, &measurement);
+      printf("%-22s %10lu %12lu %12.1f %12.3f\n", benchmark.name, size,
+             measurement.ops(), measurement.nsPerOp(),
+             measurement.allocsPerOp());
+      fflush(stdout);
+    }
+  }
+
+  return 0;
+}
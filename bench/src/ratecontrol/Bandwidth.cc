@@ -0,0 +1 @@
+../../../src/ratecontrol/Bandwidth.cc
\ No newline at end of file
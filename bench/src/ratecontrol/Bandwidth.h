@@ -0,0 +1 @@
+../../../src/ratecontrol/Bandwidth.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/BasicSender.h
\ No newline at end of file
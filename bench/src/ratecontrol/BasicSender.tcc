@@ -0,0 +1 @@
+../../../src/ratecontrol/BasicSender.tcc
\ No newline at end of file
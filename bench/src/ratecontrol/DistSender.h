@@ -0,0 +1 @@
+../../../src/ratecontrol/DistSender.h
\ No newline at end of file
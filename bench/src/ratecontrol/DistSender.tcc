@@ -0,0 +1 @@
+../../../src/ratecontrol/DistSender.tcc
\ No newline at end of file
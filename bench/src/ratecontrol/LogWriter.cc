@@ -0,0 +1 @@
+../../../src/ratecontrol/LogWriter.cc
\ No newline at end of file
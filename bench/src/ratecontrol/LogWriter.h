@@ -0,0 +1 @@
+../../../src/ratecontrol/LogWriter.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MemoryStats.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MemoryStats.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Message.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Message.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MessageFifo.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MessageFifo.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MonitorGroup.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/MonitorGroup.h
\ No newline at end of file
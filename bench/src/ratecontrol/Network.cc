@@ -0,0 +1 @@
+../../../src/ratecontrol/Network.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Network.h
\ No newline at end of file
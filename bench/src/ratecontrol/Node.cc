@@ -0,0 +1 @@
+../../../src/ratecontrol/Node.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Node.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/PeerSelector.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/PeerSelector.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/PhaseStats.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Pool.cc
\ No newline at end of file
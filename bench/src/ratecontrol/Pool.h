@@ -0,0 +1 @@
+../../../src/ratecontrol/Pool.h
\ No newline at end of file
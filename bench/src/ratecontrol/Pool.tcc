@@ -0,0 +1 @@
+../../../src/ratecontrol/Pool.tcc
\ No newline at end of file
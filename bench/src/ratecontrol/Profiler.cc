@@ -0,0 +1 @@
+../../../src/ratecontrol/Profiler.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Profiler.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/ProgressReporter.cc
\ No newline at end of file
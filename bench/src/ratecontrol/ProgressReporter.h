@@ -0,0 +1 @@
+../../../src/ratecontrol/ProgressReporter.h
\ No newline at end of file
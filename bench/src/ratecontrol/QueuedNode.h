@@ -0,0 +1 @@
+../../../src/ratecontrol/QueuedNode.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/QueuedNode.tcc
\ No newline at end of file
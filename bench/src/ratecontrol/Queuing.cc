@@ -0,0 +1 @@
+../../../src/ratecontrol/Queuing.cc
\ No newline at end of file
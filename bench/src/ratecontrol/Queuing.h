@@ -0,0 +1 @@
+../../../src/ratecontrol/Queuing.h
\ No newline at end of file
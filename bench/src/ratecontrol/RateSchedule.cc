@@ -0,0 +1 @@
+../../../src/ratecontrol/RateSchedule.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/RateSchedule.h
\ No newline at end of file
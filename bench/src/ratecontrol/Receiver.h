@@ -0,0 +1 @@
+../../../src/ratecontrol/Receiver.h
\ No newline at end of file
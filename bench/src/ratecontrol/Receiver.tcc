@@ -0,0 +1 @@
+../../../src/ratecontrol/Receiver.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/ReceiverSink.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/ReceiverSink.h
\ No newline at end of file
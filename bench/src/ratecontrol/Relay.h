@@ -0,0 +1 @@
+../../../src/ratecontrol/Relay.h
\ No newline at end of file
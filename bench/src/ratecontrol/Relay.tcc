@@ -0,0 +1 @@
+../../../src/ratecontrol/Relay.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/RelaySender.h
\ No newline at end of file
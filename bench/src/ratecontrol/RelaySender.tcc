@@ -0,0 +1 @@
+../../../src/ratecontrol/RelaySender.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Sender.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/Sender.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderConfig.cc
\ No newline at end of file
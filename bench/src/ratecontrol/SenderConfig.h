@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderConfig.h
\ No newline at end of file
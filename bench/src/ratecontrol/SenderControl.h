@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderControl.h
\ No newline at end of file
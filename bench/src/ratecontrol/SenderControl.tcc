@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderControl.tcc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderGroup.cc
\ No newline at end of file
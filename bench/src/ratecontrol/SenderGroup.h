@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderGroup.h
\ No newline at end of file
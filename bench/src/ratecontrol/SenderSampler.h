@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderSampler.h
\ No newline at end of file
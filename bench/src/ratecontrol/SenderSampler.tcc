@@ -0,0 +1 @@
+../../../src/ratecontrol/SenderSampler.tcc
\ No newline at end of file
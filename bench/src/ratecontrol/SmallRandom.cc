@@ -0,0 +1 @@
+../../../src/ratecontrol/SmallRandom.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/ratecontrol/SmallRandom.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/Trace.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/Trace.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/TraceReader.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/TraceReader.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/TraceWriter.cc
\ No newline at end of file
@@ -0,0 +1 @@
+../../../src/trace/TraceWriter.h
\ No newline at end of file
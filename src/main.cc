@@ -33,28 +33,180 @@
 #include <prim/prim.h>
 #include <settings/settings.h>
 
+#include <unistd.h>
+
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <iomanip>
+#include <random>
 #include <sstream>
 #include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include "ratecontrol/Bandwidth.h"
 #include "ratecontrol/BasicSender.h"
 #include "ratecontrol/DistSender.h"
+#include "ratecontrol/LogWriter.h"
+#include "ratecontrol/MemoryStats.h"
+#include "ratecontrol/Message.h"
 #include "ratecontrol/Network.h"
+#include "ratecontrol/Node.h"
+#include "ratecontrol/PhaseStats.h"
+#include "ratecontrol/Pool.h"
+#include "ratecontrol/Profiler.h"
+#include "ratecontrol/ProgressReporter.h"
+#include "ratecontrol/Queuing.h"
 #include "ratecontrol/Receiver.h"
+#include "ratecontrol/ReceiverSink.h"
 #include "ratecontrol/Relay.h"
 #include "ratecontrol/RelaySender.h"
 #include "ratecontrol/Sender.h"
+#include "ratecontrol/SenderConfig.h"
 #include "ratecontrol/SenderControl.h"
+#include "ratecontrol/SenderGroup.h"
+#include "ratecontrol/SenderSampler.h"
+#include "trace/TraceWriter.h"
+
+// these are the optional recorders attached to every node
+struct Observers {
+  PhaseStats* phaseStats;
+  TraceWriter* trace;
+  Bandwidth* bandwidth;
+};
+
+u64 residentBytes();
+
+// this records the wall time and resident memory growth of each startup phase
+struct Startup {
+  struct Phase {
+    std::string name;
+    f64 seconds;
+    s64 bytes;
+  };
+
+  Startup()
+      : last(std::chrono::steady_clock::now()), lastBytes(residentBytes()) {}
+
+  // this ends the current phase
+  void lap(const std::string& _phase) {
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    u64 bytes = residentBytes();
+    phases.push_back({_phase, std::chrono::duration<f64>(now - last).count(),
+                      (s64)bytes - (s64)lastBytes});
+    last = now;
+    lastBytes = bytes;
+  }
+
+  std::chrono::steady_clock::time_point last;
+  u64 lastBytes;
+  std::vector<Phase> phases;
+};
+
+// this calls '_func(index)' for all indices in [0, _count), split in contiguous
+//  ranges over up to '_threads' threads. it is only for pure work, libdes
+//  doesn't state that constructing des::Models concurrently is safe, so the
+//  nodes are constructed one after another
+template <typename Func>
+void parallelFor(u32 _count, u32 _threads, Func _func) {
+  const u32 MIN_RANGE = 4096;  // not worth a thread below this
+  u32 threads = std::max(1u, std::min(_threads, _count / MIN_RANGE));
+  std::vector<std::thread> workers;
+  for (u32 t = 1; t < threads; t++) {
+    workers.emplace_back([=]() {
+        for (u32 idx = (u64)_count * t / threads;
+             idx < (u64)_count * (t + 1) / threads; idx++) {
+          _func(idx);
+        }
+      });
+  }
+  for (u32 idx = 0; idx < _count / threads; idx++) {
+    _func(idx);
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
 
 std::string createName(const std::string& _prefix, u32 _id, u32 _total);
+std::vector<std::string> createNames(const std::string& _prefix, u32 _total,
+                                     u32 _threads);
+std::string createName(const std::string& _prefix, u32 _firstId, u32 _lastId,
+                       u32 _total);
+void observe(Node* _node, Bandwidth::NodeClass _nodeClass,
+             const Observers& _observers);
+void simulate(des::Simulator* _sim, const Network* _network,
+              const Json::Value& _settings);
+
+template <typename Queuing>
+void runQueuing(des::Simulator* _sim, Network* _network,
+                const Observers& _observers, const Json::Value& _settings,
+                const SenderConfig* _senderConfig, Startup* _startup);
+
+// these create a sampler for the senders that have state worth sampling
+template <typename Queuing>
+des::Model* createSampler(des::Simulator* _sim,
+                          std::vector<BasicSender<Queuing>*>* _senders,
+                          const Json::Value& _settings) {
+  (void)_sim;  // unused
+  (void)_senders;  // unused
+  (void)_settings;  // unused
+  return nullptr;
+}
+
+template <typename Queuing>
+des::Model* createSampler(des::Simulator* _sim,
+                          std::vector<RelaySender<Queuing>*>* _senders,
+                          const Json::Value& _settings) {
+  (void)_sim;  // unused
+  (void)_senders;  // unused
+  (void)_settings;  // unused
+  return nullptr;
+}
+
+template <typename Queuing>
+des::Model* createSampler(des::Simulator* _sim,
+                          std::vector<DistSender<Queuing>*>* _senders,
+                          const Json::Value& _settings) {
+  // sample every 1000 ticks until the first sample past 90000 (i.e. 91000)
+  //  unless configured, as the senders' stats printing used to
+  des::Tick period = _settings["sample_period"].isNull() ? 1000 :
+      (des::Tick)_settings["sample_period"].asUInt64();
+  des::Tick horizon = _settings["sample_horizon"].isNull() ? 90000 :
+      (des::Tick)_settings["sample_horizon"].asUInt64();
+  if (period == 0) {
+    return nullptr;
+  }
+  SenderSampler<DistSender<Queuing> >* sampler =
+      new SenderSampler<DistSender<Queuing> >(
+          _sim, "SenderSampler", nullptr, _senders, period, horizon);
+  sampler->debug = _settings["verbosity"].asUInt() > 1;
+  return sampler;
+}
+
+template <typename Queuing, typename SenderType>
+void runAlgorithm(des::Simulator* _sim, Network* _network,
+                  const Observers& _observers, const Json::Value& _settings,
+                  const SenderConfig* _senderConfig, u32 _numReceivers,
+                  const std::vector<Relay<Queuing>*>& _relays,
+                  Startup* _startup);
+
+template <typename Queuing>
+void runGroups(des::Simulator* _sim, Network* _network,
+               const Observers& _observers, const Json::Value& _settings,
+               const SenderConfig* _senderConfig, u32 _numReceivers,
+               const std::vector<Relay<Queuing>*>& _relays,
+               Startup* _startup);
 
 s32 main(s32 _argc, char** _argv) {
+  Startup startup;
   Json::Value settings;
   settings::commandLine(_argc, _argv, &settings);
 
@@ -70,6 +222,14 @@ s32 main(s32 _argc, char** _argv) {
   u32 verbosity = settings["verbosity"].asUInt();
   std::string algorithm = settings["algorithm"].asString();
   std::string logFile = settings["log_file"].asString();
+  std::string statsFile = settings["stats_file"].asString();
+  std::string traceFile = settings["trace_file"].asString();
+  bool traceCompress = settings["trace_compress"].asBool();
+  std::string bandwidthFile = settings["bandwidth_file"].asString();
+  des::Tick bandwidthBucket =
+      (des::Tick)settings["bandwidth_bucket"].asUInt64();
+  u32 groupSize = settings["sender_group_size"].asUInt();
+  bool profileHandlers = settings["profile_handlers"].asBool();
 
   // verify inputs
   if (numSenders < 1) {
@@ -93,112 +253,514 @@ s32 main(s32 _argc, char** _argv) {
             " the minimum message size\n");
     exit(-1);
   }
+  if (algorithm != "basic" && algorithm != "relay" && algorithm != "dist") {
+    fprintf(stderr, "invalid algorithm: %s\n", algorithm.c_str());
+    exit(-1);
+  }
+  if (groupSize > 1 && algorithm == "dist") {
+    fprintf(stderr, "sender groups don't support the dist algorithm\n");
+    exit(-1);
+  }
+  if (!bandwidthFile.empty() && bandwidthBucket == 0) {
+    fprintf(stderr, "bandwidth bucket must be greater than 0\n");
+    exit(-1);
+  }
+
+  // parse and verify the sender configuration once for all senders
+  const SenderConfig senderConfig(settings);
+
+  // without a seed, pick one and record it so the run can be reproduced
+  if (settings["seed"].isNull()) {
+    std::random_device rnd;
+    settings["seed"] = Json::Value::UInt64(
+        ((u64)rnd() << 32) | (u64)rnd());
+  }
 
   // create the simulation environment
   des::Simulator sim(numThreads);
 
-  // create a logger for the simulation
-  des::Logger logger(logFile);
-  sim.setLogger(&logger);
+  // create a logger for the simulation, a gzip log is compressed by a
+  //  background thread
+  LogWriter* logWriter = nullptr;
+  const std::string gzip = ".gz";
+  if (logFile.size() > gzip.size() &&
+      logFile.compare(logFile.size() - gzip.size(), gzip.size(), gzip) == 0) {
+    logWriter = new LogWriter(logFile);
+  }
+  des::Logger* logger = new des::Logger(
+      logWriter != nullptr ? logWriter->path() : logFile);
+  sim.setLogger(logger);
 
   // log the configuration
   if (verbosity > 0) {
     std::string conf = settings::toString(settings);
-    logger.log(conf.c_str(), conf.size());
+    logger->log(conf.c_str(), conf.size());
   }
 
+  startup.lap("settings");
+
   // create a Network
   Network network(&sim, "Network", nullptr, networkDelay);
   network.debug = verbosity > 1;
+  network.reserve(numReceivers + numRelays + numSenders);
+
+  // create the statistics collector if requested
+  PhaseStats* phaseStats = nullptr;
+  if (!statsFile.empty()) {
+    std::vector<des::Tick> schedule;
+    for (const Json::Value& rateChange : settings["sender_control"]) {
+      schedule.push_back(rateChange[0].asUInt64());
+    }
+    phaseStats = new PhaseStats(schedule);
+  }
+
+  // create the binary trace writer if requested
+  TraceWriter* trace = nullptr;
+  if (!traceFile.empty()) {
+    trace = new TraceWriter(traceFile, traceCompress);
+  }
+
+  // create the bandwidth accumulators if requested
+  Bandwidth* bandwidth = nullptr;
+  if (!bandwidthFile.empty()) {
+    bandwidth = new Bandwidth(bandwidthBucket);
+  }
+  Observers observers = {phaseStats, trace, bandwidth};
+
+  // count the calls and time of the event handlers if requested
+  if (profileHandlers) {
+    Profiler::enable();
+  }
+  startup.lap("network");
+
+  // run the simulation specialized for the queuing discipline
+  if (queuing == "fifo") {
+    runQueuing<FifoQueuing>(&sim, &network, observers, settings,
+                            &senderConfig, &startup);
+  } else if (queuing == "priority") {
+    runQueuing<PriorityQueuing>(&sim, &network, observers, settings,
+                                &senderConfig, &startup);
+  } else {
+    fprintf(stderr, "invalid queuing: %s\n", queuing.c_str());
+    exit(-1);
+  }
+
+  // report where the simulation spent its time
+  if (profileHandlers) {
+    std::string profile = Profiler::toString();
+    logger->log(profile.c_str(), profile.size());
+  }
+
+  // finish the binary trace
+  if (trace) {
+    trace->close();
+    delete trace;
+  }
+
+  // write the statistics
+  if (phaseStats) {
+    std::string stats = phaseStats->toString();
+    FILE* fp = fopen(statsFile.c_str(), "w");
+    if (fp == nullptr) {
+      fprintf(stderr, "couldn't open stats file: %s\n", statsFile.c_str());
+      exit(-1);
+    }
+    fwrite(stats.c_str(), 1, stats.size(), fp);
+    fclose(fp);
+    delete phaseStats;
+  }
+
+  // write the bandwidth table
+  if (bandwidth) {
+    std::string table = bandwidth->toString();
+    FILE* fp = fopen(bandwidthFile.c_str(), "w");
+    if (fp == nullptr) {
+      fprintf(stderr, "couldn't open bandwidth file: %s\n",
+              bandwidthFile.c_str());
+      exit(-1);
+    }
+    fwrite(table.c_str(), 1, table.size(), fp);
+    fclose(fp);
+    delete bandwidth;
+  }
+
+  // report memory pool usage
+  if (verbosity > 0) {
+    std::stringstream ss;
+    ss << Pool<Message>::stats().toString("Message");
+    ss << Pool<MessageEvent>::stats().toString("MessageEvent");
+    ss << Pool<NodeEvent>::stats().toString("NodeEvent");
+    ss << Pool<TimerEvent>::stats().toString("TimerEvent");
+    ss << MemoryStats::toString();
+    std::string poolStats = ss.str();
+    logger->log(poolStats.c_str(), poolStats.size());
+  }
+
+  // all nodes are deleted, flag anything that wasn't freed
+  std::string leaks = MemoryStats::leaks();
+  if (!leaks.empty()) {
+    fprintf(stderr, "%s", leaks.c_str());
+    logger->log(leaks.c_str(), leaks.size());
+  }
+
+  // report the startup time and memory breakdown, the memory of the node
+  //  phases divided by the number of node ids gives the bytes per node
+  if (verbosity > 0) {
+    std::stringstream ss;
+    f64 total = 0.0;
+    s64 nodeBytes = 0;
+    for (const Startup::Phase& phase : startup.phases) {
+      ss << "Startup " << phase.name << " seconds: " << phase.seconds << '\n';
+      ss << "Startup " << phase.name << " bytes: " << phase.bytes << '\n';
+      total += phase.seconds;
+      if (phase.name == "receivers" || phase.name == "relays" ||
+          phase.name == "senders") {
+        nodeBytes += phase.bytes;
+      }
+    }
+    ss << "Startup total seconds: " << total << '\n';
+    ss << "Bytes per node: " << ((f64)nodeBytes / network.size()) << '\n';
+    std::string startupTimes = ss.str();
+    logger->log(startupTimes.c_str(), startupTimes.size());
+  }
+
+  // the logger must be closed before the log writer can finish
+  delete logger;
+  if (logWriter) {
+    logWriter->close();
+    delete logWriter;
+  }
+
+  return 0;
+}
+
+template <typename Queuing>
+void runQueuing(des::Simulator* _sim, Network* _network,
+                const Observers& _observers, const Json::Value& _settings,
+                const SenderConfig* _senderConfig, Startup* _startup) {
+  u32 numReceivers = _settings["receivers"].asUInt();
+  u32 numRelays = _settings["relays"].asUInt();
+  f64 rateLimit = _settings["rate_limit"].asDouble();
+  u32 verbosity = _settings["verbosity"].asUInt();
+  u64 seed = _settings["seed"].asUInt64();
+  std::string algorithm = _settings["algorithm"].asString();
+  u32 groupSize = _settings["sender_group_size"].asUInt();
+  bool receiverSink = _settings["receiver_sink"].asBool();
+  u32 numThreads = _settings["threads"].asUInt();
 
-  // create receivers
+  // create receivers, either individually or in sinks. receivers have the ids
+  //  [0, numReceivers). the sinks split the ids into contiguous ranges, a few
+  //  per thread, so receives aren't serialized on a single model
   u32 nodeId = 0;
-  std::vector<Receiver*> receivers(numReceivers, nullptr);
-  for (u32 r = 0; r < numReceivers; r++) {
-    receivers.at(r) = new Receiver(
-        &sim, createName("Receiver", r, numReceivers), nullptr, nodeId++,
-        queuing, &network);
-    receivers.at(r)->debug = verbosity > 1;
+  std::vector<ReceiverSink*> sinks;
+  std::vector<Receiver<Queuing>*> receivers(
+      receiverSink ? 0 : numReceivers, nullptr);
+  if (receiverSink) {
+    const u32 SINKS_PER_THREAD = 4;  // spreads the sinks evenly over threads
+    u32 numSinks = std::min(
+        numReceivers, std::max(1u, numThreads) * SINKS_PER_THREAD);
+    for (u32 s = 0; s < numSinks; s++) {
+      u32 first = (u64)numReceivers * s / numSinks;
+      u32 last = (u64)numReceivers * (s + 1) / numSinks - 1;
+      ReceiverSink* sink = new ReceiverSink(
+          _sim, createName("Receiver", first, last, numReceivers), nullptr,
+          nodeId + first, last - first + 1, _network);
+      sink->debug = verbosity > 1;
+      sink->seed(seed);
+      observe(sink, Bandwidth::RECEIVER, _observers);
+      sinks.push_back(sink);
+    }
+    nodeId += numReceivers;
+  }
+  std::vector<std::string> receiverNames =
+      createNames("Receiver", receivers.size(), numThreads);
+  for (u32 r = 0; r < receivers.size(); r++) {
+    Receiver<Queuing>* receiver = new Receiver<Queuing>(
+        _sim, receiverNames[r], nullptr, nodeId + r, _network);
+    receiver->debug = verbosity > 1;
+    receiver->seed(seed);
+    observe(receiver, Bandwidth::RECEIVER, _observers);
+    receivers[r] = receiver;
   }
+  nodeId += receivers.size();
+  _startup->lap("receivers");
 
   // create relays
-  std::vector<Relay*> relays(numRelays, nullptr);
+  std::vector<Relay<Queuing>*> relays(numRelays, nullptr);
+  f64 relayRateLimit = rateLimit / numRelays;
+  assert(numRelays == 0 || relayRateLimit <= 1.0);
+  std::vector<std::string> relayNames =
+      createNames("Relay", numRelays, numThreads);
+  for (u32 r = 0; r < numRelays; r++) {
+    Relay<Queuing>* relay = new Relay<Queuing>(
+        _sim, relayNames[r], nullptr, nodeId + r, _network, relayRateLimit);
+    relay->debug = verbosity > 1;
+    relay->seed(seed);
+    observe(relay, Bandwidth::RELAY, _observers);
+    relays[r] = relay;
+  }
+  nodeId += numRelays;
+  _startup->lap("relays");
+
+  // run the simulation specialized for the sender algorithm
+  if (groupSize > 1) {
+    runGroups<Queuing>(_sim, _network, _observers, _settings, _senderConfig,
+                       numReceivers, relays, _startup);
+  } else if (algorithm == "basic") {
+    runAlgorithm<Queuing, BasicSender<Queuing> >(
+        _sim, _network, _observers, _settings, _senderConfig, numReceivers,
+        relays, _startup);
+  } else if (algorithm == "relay") {
+    runAlgorithm<Queuing, RelaySender<Queuing> >(
+        _sim, _network, _observers, _settings, _senderConfig, numReceivers,
+        relays, _startup);
+  } else if (algorithm == "dist") {
+    runAlgorithm<Queuing, DistSender<Queuing> >(
+        _sim, _network, _observers, _settings, _senderConfig, numReceivers,
+        relays, _startup);
+  } else {
+    assert(false);  // verified in main()
+  }
+
+  // report the receiver counters
+  if (!sinks.empty() && verbosity > 0) {
+    std::string sinkStats = ReceiverSink::toString(sinks);
+    _sim->getLogger()->log(sinkStats.c_str(), sinkStats.size());
+  }
+
+  // cleanup
+  for (ReceiverSink* sink : sinks) {
+    delete sink;
+  }
+  for (u32 r = 0; r < receivers.size(); r++) {
+    delete receivers.at(r);
+  }
   for (u32 r = 0; r < numRelays; r++) {
-    f64 relayRateLimit = rateLimit / numRelays;
-    assert(relayRateLimit <= 1.0);
-    relays.at(r) = new Relay(&sim, createName("Relay", r, numRelays),
-                             nullptr, nodeId++, queuing, &network,
-                             relayRateLimit);
-    relays.at(r)->debug = verbosity > 1;
+    delete relays.at(r);
   }
+}
+
+// these inform senders of any IDs they need
+template <typename Queuing>
+void linkSenders(std::vector<BasicSender<Queuing>*>* _senders,
+                 const std::vector<Relay<Queuing>*>& _relays) {
+  (void)_senders;  // unused
+  (void)_relays;  // unused
+}
+
+template <typename Queuing>
+void linkSenders(std::vector<RelaySender<Queuing>*>* _senders,
+                 const std::vector<Relay<Queuing>*>& _relays) {
+  for (RelaySender<Queuing>* sender : *_senders) {
+    sender->relayIds(_relays.at(0)->id, _relays.at(_relays.size() - 1)->id);
+  }
+}
+
+template <typename Queuing>
+void linkSenders(std::vector<DistSender<Queuing>*>* _senders,
+                 const std::vector<Relay<Queuing>*>& _relays) {
+  (void)_relays;  // unused
+  for (DistSender<Queuing>* sender : *_senders) {
+    sender->distIds(_senders->at(0)->id,
+                    _senders->at(_senders->size() - 1)->id);
+  }
+}
+
+template <typename Queuing, typename SenderType>
+void runAlgorithm(des::Simulator* _sim, Network* _network,
+                  const Observers& _observers, const Json::Value& _settings,
+                  const SenderConfig* _senderConfig, u32 _numReceivers,
+                  const std::vector<Relay<Queuing>*>& _relays,
+                  Startup* _startup) {
+  u32 numSenders = _settings["senders"].asUInt();
+  f64 rateLimit = _settings["rate_limit"].asDouble();
+  u32 minMessageSize = _settings["min_message_size"].asUInt();
+  u32 maxMessageSize = _settings["max_message_size"].asUInt();
+  u32 verbosity = _settings["verbosity"].asUInt();
+  u64 seed = _settings["seed"].asUInt64();
+  u32 numThreads = _settings["threads"].asUInt();
 
   // create senders
-  std::vector<Sender*> senders(numSenders, nullptr);
+  u32 nodeId = _numReceivers + _relays.size();
+  std::vector<SenderType*> senders(numSenders, nullptr);
+  std::vector<std::string> senderNames =
+      createNames("Sender", numSenders, numThreads);
   for (u32 s = 0; s < numSenders; s++) {
-    if (algorithm == "basic") {
-      senders.at(s) = new BasicSender(
-          &sim, createName("Sender", s, numSenders), nullptr,
-          nodeId++, queuing, &network, minMessageSize,
-          maxMessageSize, receivers.at(0)->id,
-          receivers.at(numReceivers - 1)->id,
-          settings["sender_config"]);
-    } else if (algorithm == "relay") {
-      senders.at(s) = new RelaySender(
-          &sim, createName("Sender", s, numSenders), nullptr,
-          nodeId++, queuing, &network, minMessageSize,
-          maxMessageSize, receivers.at(0)->id,
-          receivers.at(numReceivers - 1)->id,
-          settings["sender_config"]);
-    } else if (algorithm == "dist") {
-      senders.at(s) = new DistSender(
-          &sim, createName("Sender", s, numSenders), nullptr,
-          nodeId++, queuing, &network, minMessageSize,
-          maxMessageSize, receivers.at(0)->id,
-          receivers.at(numReceivers - 1)->id,
-          rateLimit, settings["sender_config"]);
-    } else {
-      fprintf(stderr, "invalid algorithm: %s\n", algorithm.c_str());
-      exit(-1);
-    }
-    senders.at(s)->debug = verbosity > 1;
+    SenderType* sender = new SenderType(
+        _sim, senderNames[s], nullptr, nodeId + s, _network, minMessageSize,
+        maxMessageSize, 0, _numReceivers - 1, rateLimit, _senderConfig);
+    sender->debug = verbosity > 1;
+    sender->seed(seed);
+    observe(sender, Bandwidth::SENDER, _observers);
+    senders[s] = sender;
   }
+  _startup->lap("senders");
 
   // inform senders of any IDs they need
+  linkSenders(&senders, _relays);
+  _startup->lap("linking");
+
+  // create a sender control unit for controlling desired injection rate
+  SenderControl<SenderType> senderControl(
+      _sim, "SenderControl", nullptr, &senders, _settings["sender_control"]);
+  senderControl.debug = verbosity > 0;
+
+  // create a sampler of the senders' state
+  des::Model* sampler = createSampler(_sim, &senders, _settings);
+  _startup->lap("control");
+
+  // run simulation
+  simulate(_sim, _network, _settings);
+
+  // cleanup
+  delete sampler;
   for (u32 s = 0; s < numSenders; s++) {
-    if (algorithm == "relay") {
-      reinterpret_cast<RelaySender*>(senders.at(s))->relayIds(
-          relays.at(0)->id, relays.at(numRelays - 1)->id);
-    } else if (algorithm == "dist") {
-      reinterpret_cast<DistSender*>(senders.at(s))->distIds(
-          senders.at(0)->id, senders.at(numSenders - 1)->id);
+    delete senders.at(s);
+  }
+}
+
+template <typename Queuing>
+void runGroups(des::Simulator* _sim, Network* _network,
+               const Observers& _observers, const Json::Value& _settings,
+               const SenderConfig* _senderConfig, u32 _numReceivers,
+               const std::vector<Relay<Queuing>*>& _relays,
+               Startup* _startup) {
+  u32 numSenders = _settings["senders"].asUInt();
+  u32 groupSize = _settings["sender_group_size"].asUInt();
+  bool relay = _settings["algorithm"].asString() == "relay";
+  u32 minMessageSize = _settings["min_message_size"].asUInt();
+  u32 maxMessageSize = _settings["max_message_size"].asUInt();
+  u32 verbosity = _settings["verbosity"].asUInt();
+  u64 seed = _settings["seed"].asUInt64();
+
+  // create groups of consecutive senders, each logical sender refers to its
+  //  group so the sender control unit sees one entry per logical sender
+  u32 nodeId = _numReceivers + _relays.size();
+  std::vector<SenderGroup*> groups;
+  std::vector<SenderGroup*> senders(numSenders, nullptr);
+  for (u32 first = 0; first < numSenders; first += groupSize) {
+    u32 size = std::min(groupSize, numSenders - first);
+    SenderGroup* group = new SenderGroup(
+        _sim, createName("Sender", first, first + size - 1, numSenders),
+        nullptr, nodeId, size, _network, relay, minMessageSize,
+        maxMessageSize, 0, _numReceivers - 1, _senderConfig);
+    nodeId += size;
+    group->debug = verbosity > 1;
+    group->seed(seed);
+    observe(group, Bandwidth::SENDER, _observers);
+    if (relay) {
+      group->relayIds(_relays.at(0)->id, _relays.at(_relays.size() - 1)->id);
+    }
+    groups.push_back(group);
+    for (u32 s = first; s < first + size; s++) {
+      senders.at(s) = group;
     }
   }
+  _startup->lap("senders");
 
   // create a sender control unit for controlling desired injection rate
-  SenderControl senderControl(&sim, "SenderControl", nullptr, &senders,
-                              settings["sender_control"]);
+  SenderControl<SenderGroup> senderControl(
+      _sim, "SenderControl", nullptr, &senders, _settings["sender_control"]);
   senderControl.debug = verbosity > 0;
+  _startup->lap("control");
 
   // run simulation
-  sim.simulate(verbosity > 0);
+  simulate(_sim, _network, _settings);
 
   // cleanup
-  for (u32 r = 0; r < numReceivers; r++) {
-    delete receivers.at(r);
+  for (SenderGroup* group : groups) {
+    delete group;
   }
-  for (u32 r = 0; r < numRelays; r++) {
-    delete relays.at(r);
+}
+
+std::string createName(const std::string& _prefix, u32 _id, u32 _total) {
+  // format the zero padded id backwards into a small buffer, this is called
+  //  once per node so it avoids the stream machinery
+  u32 digits = 1;
+  for (u64 total = _total; total > 10; total = (total + 9) / 10) {
+    digits++;
   }
-  for (u32 s = 0; s < numSenders; s++) {
-    delete senders.at(s);
+  char buffer[10];
+  char* end = buffer + sizeof(buffer);
+  char* pos = end;
+  for (u32 id = _id; pos > buffer && (id > 0 || end - pos < (s64)digits);
+       id /= 10) {
+    *--pos = '0' + (id % 10);
   }
+  std::string name;
+  name.reserve(_prefix.size() + 1 + (end - pos));
+  name.append(_prefix);
+  name.push_back('_');
+  name.append(pos, end);
+  return name;
+}
 
-  return 0;
+std::vector<std::string> createNames(const std::string& _prefix, u32 _total,
+                                     u32 _threads) {
+  std::vector<std::string> names(_total);
+  parallelFor(_total, _threads, [&](u32 _id) {
+      names[_id] = createName(_prefix, _id, _total);
+    });
+  return names;
 }
 
-std::string createName(const std::string& _prefix, u32 _id, u32 _total) {
+std::string createName(const std::string& _prefix, u32 _firstId, u32 _lastId,
+                       u32 _total) {
   u32 digits = (u32)ceil(log10(_total));
   std::stringstream ss;
-  ss << _prefix << '_' << std::setw(digits) << std::setfill('0') << _id;
+  ss << createName(_prefix, _firstId, _total) << '-' << std::setw(digits)
+     << std::setfill('0') << _lastId;
   return ss.str();
 }
+
+u64 residentBytes() {
+  // the second field of statm is the resident set size in pages
+  u64 pages = 0;
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp != nullptr) {
+    if (fscanf(fp, "%*u %lu", &pages) != 1) {
+      pages = 0;
+    }
+    fclose(fp);
+  }
+  return pages * sysconf(_SC_PAGESIZE);
+}
+
+void observe(Node* _node, Bandwidth::NodeClass _nodeClass,
+             const Observers& _observers) {
+  _node->setPhaseStats(_observers.phaseStats);
+  _node->setTrace(_observers.trace);
+  _node->setBandwidth(_observers.bandwidth, _nodeClass);
+}
+
+void simulate(des::Simulator* _sim, const Network* _network,
+              const Json::Value& _settings) {
+  u32 verbosity = _settings["verbosity"].asUInt();
+  std::string progressFile = _settings["progress_file"].asString();
+
+  // report the progress every 10 seconds unless configured, the ETA is to
+  //  the last rate change
+  ProgressReporter* progress = nullptr;
+  if (!progressFile.empty()) {
+    f64 period = _settings["progress_period"].isNull() ? 10.0 :
+        _settings["progress_period"].asDouble();
+    if (period <= 0.0) {
+      // the reporter would wake up continuously
+      fprintf(stderr, "progress period must be greater than 0.0\n");
+      exit(-1);
+    }
+    des::Tick endTick = 0;
+    for (const Json::Value& rateChange : _settings["sender_control"]) {
+      endTick = std::max(endTick, (des::Tick)rateChange[0].asUInt64());
+    }
+    progress = new ProgressReporter(_network, progressFile, period, endTick);
+    progress->start();
+  }
+
+  _sim->simulate(verbosity > 0);
+
+  if (progress) {
+    progress->stop();
+    delete progress;
+  }
+}
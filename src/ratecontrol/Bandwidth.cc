@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/Bandwidth.h"
+
+#include <cassert>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+const char* CLASS_NAMES[] = {"Sender", "Receiver", "Relay"};
+}  // namespace
+
+Bandwidth::Bandwidth(des::Tick _bucketWidth)
+    : bucketWidth_(_bucketWidth), shards_([] { return new Shard(); }) {
+  assert(bucketWidth_ > 0);
+}
+
+Bandwidth::~Bandwidth() {}
+
+void Bandwidth::recordSend(NodeClass _class, des::Tick _start, u32 _size,
+                           bool _control) {
+  assert(_size > 0);
+  record((_class * 2 + 0) * 2 + (_control ? 1 : 0), _start,
+         _start + _size - 1);
+}
+
+void Bandwidth::recordRecv(NodeClass _class, des::Tick _end, u32 _size,
+                           bool _control) {
+  assert(_size > 0);
+  record((_class * 2 + 1) * 2 + (_control ? 1 : 0),
+         _end + 1 >= _size ? _end + 1 - _size : 0, _end);
+}
+
+std::string Bandwidth::toString() const {
+  // merge all shards
+  std::vector<u64> phits;
+  for (const Shard* shard : shards_.all()) {
+    if (shard->phits.size() > phits.size()) {
+      phits.resize(shard->phits.size(), 0);
+    }
+    for (u64 idx = 0; idx < shard->phits.size(); idx++) {
+      phits[idx] += shard->phits[idx];
+    }
+  }
+
+  std::stringstream ss;
+  ss << std::setprecision(10);
+  ss << "tick";
+  for (u32 cls = 0; cls < NUM_CLASSES; cls++) {
+    for (const char* dir : {"send", "recv"}) {
+      for (const char* traffic : {"plain", "control"}) {
+        ss << ',' << CLASS_NAMES[cls] << '_' << dir << '_' << traffic;
+      }
+    }
+  }
+  ss << '\n';
+  for (u64 bucket = 0; bucket < phits.size() / COLUMNS; bucket++) {
+    ss << (bucket * bucketWidth_);
+    for (u32 col = 0; col < COLUMNS; col++) {
+      ss << ',' << ((f64)phits[bucket * COLUMNS + col] / bucketWidth_);
+    }
+    ss << '\n';
+  }
+  return ss.str();
+}
+
+void Bandwidth::record(u32 _column, des::Tick _first, des::Tick _last) {
+  Shard* s = shards_.get();
+  u64 lastBucket = _last / bucketWidth_;
+  if (s->phits.size() < (lastBucket + 1) * COLUMNS) {
+    s->phits.resize((lastBucket + 1) * COLUMNS, 0);
+  }
+  for (u64 bucket = _first / bucketWidth_; bucket <= lastBucket; bucket++) {
+    des::Tick lo = std::max(_first, bucket * bucketWidth_);
+    des::Tick hi = std::min(_last, (bucket + 1) * bucketWidth_ - 1);
+    s->phits[bucket * COLUMNS + _column] += hi - lo + 1;
+  }
+}
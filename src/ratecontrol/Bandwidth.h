@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_BANDWIDTH_H_
+#define RATECONTROL_BANDWIDTH_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+#include "ratecontrol/PerThread.h"
+
+/*
+ * This accumulates the phits sent and received by each class of node into
+ *  fixed width time buckets, split into plain and control traffic. As in
+ *  parser/parser.py, a message sent at tick T occupies [T, T+size-1] and a
+ *  message received at tick T occupies [T-size+1, T].
+ *
+ * Phits are recorded into per-thread shards without locking and merged when
+ *  the table is reported.
+ */
+class Bandwidth {
+ public:
+  enum NodeClass : u8 {
+    SENDER = 0,
+    RECEIVER = 1,
+    RELAY = 2,
+    NUM_CLASSES = 3
+  };
+
+  explicit Bandwidth(des::Tick _bucketWidth);
+  ~Bandwidth();
+
+  void recordSend(NodeClass _class, des::Tick _start, u32 _size,
+                  bool _control);
+  void recordRecv(NodeClass _class, des::Tick _end, u32 _size,
+                  bool _control);
+
+  /*
+   * This formats the average bandwidth (phits/tick) of each bucket as CSV,
+   *  one row per bucket and one column per class, direction and traffic type.
+   */
+  std::string toString() const;
+
+ private:
+  // columns are ordered by class, then direction, then traffic type
+  static const u32 COLUMNS = NUM_CLASSES * 2 * 2;
+
+  struct Shard {
+    std::vector<u64> phits;  // bucket major
+  };
+
+  void record(u32 _column, des::Tick _first, des::Tick _last);
+
+  const des::Tick bucketWidth_;
+  PerThread<Shard> shards_;
+};
+
+#endif  // RATECONTROL_BANDWIDTH_H_
@@ -31,28 +31,38 @@
 #ifndef RATECONTROL_BASICSENDER_H_
 #define RATECONTROL_BASICSENDER_H_
 
-#include <jsoncpp/json/json.h>
 #include <prim/prim.h>
 
 #include <string>
 
 #include "ratecontrol/Sender.h"
+#include "ratecontrol/SenderConfig.h"
 
 class Message;
 class Network;
 
-class BasicSender : public Sender {
+template <typename Queuing>
+class BasicSender : public Sender<BasicSender<Queuing>, Queuing> {
+ private:
+  typedef Sender<BasicSender<Queuing>, Queuing> Base;
+  friend Base;
+
  public:
   BasicSender(des::Simulator* _sim, const std::string& _name,
-              const des::Model* _parent, u32 _id, const std::string& _queuing,
-              Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
-              u32 _receiverMinId, u32 _receiverMaxId, Json::Value _settings);
+              const des::Model* _parent, u32 _id, Network* _network,
+              u32 _minMessageSize, u32 _maxMessageSize, u32 _receiverMinId,
+              u32 _receiverMaxId, f64 _rateLimit,
+              const SenderConfig* _config);
   ~BasicSender();
 
-  void recv(Message* _msg) override;
+  void recv(Message* _msg);
 
  protected:
-  void sendMessage(Message* _msg) override;
+  using Base::send;
+
+  void sendMessage(Message* _msg);
 };
 
+#include "ratecontrol/BasicSender.tcc"
+
 #endif  // RATECONTROL_BASICSENDER_H_
@@ -28,30 +28,36 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include "ratecontrol/BasicSender.h"
+#ifndef RATECONTROL_BASICSENDER_H_
+#error "do not include this file, include BasicSender.h instead"
+#endif  // RATECONTROL_BASICSENDER_H_
 
 #include <cassert>
 
 #include "ratecontrol/Message.h"
 
-BasicSender::BasicSender(des::Simulator* _sim, const std::string& _name,
-                         const des::Model* _parent, u32 _id,
-                         const std::string& _queuing, Network* _network,
-                         u32 _minMessageSize, u32 _maxMessageSize,
-                         u32 _receiverMinId, u32 _receiverMaxId,
-                         Json::Value _settings)
-    : Sender(_sim, _name, _parent, _id, _queuing, _network, _minMessageSize,
-             _maxMessageSize, _receiverMinId, _receiverMaxId) {
-  (void)_settings;  // unused
+template <typename Queuing>
+BasicSender<Queuing>::BasicSender(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
+    u32 _receiverMinId, u32 _receiverMaxId, f64 _rateLimit,
+    const SenderConfig* _config)
+    : Base(_sim, _name, _parent, _id, _network, _minMessageSize,
+           _maxMessageSize, _receiverMinId, _receiverMaxId) {
+  (void)_rateLimit;  // unused
+  (void)_config;  // unused
 }
 
-BasicSender::~BasicSender() {}
+template <typename Queuing>
+BasicSender<Queuing>::~BasicSender() {}
 
-void BasicSender::recv(Message* _msg) {
+template <typename Queuing>
+void BasicSender<Queuing>::recv(Message* _msg) {
   (void)_msg;  // unused
   assert(false);
 }
 
-void BasicSender::sendMessage(Message* _msg) {
+template <typename Queuing>
+void BasicSender<Queuing>::sendMessage(Message* _msg) {
   send(_msg);
 }
@@ -31,43 +31,53 @@
 #ifndef RATECONTROL_DISTSENDER_H_
 #define RATECONTROL_DISTSENDER_H_
 
-#include <jsoncpp/json/json.h>
 #include <prim/prim.h>
 
-#include <queue>
 #include <string>
+#include <vector>
 
+#include "ratecontrol/MessageFifo.h"
+#include "ratecontrol/PeerSelector.h"
 #include "ratecontrol/Sender.h"
+#include "ratecontrol/SenderConfig.h"
 
 class Message;
 class Network;
 
-class DistSender : public Sender {
- public:
-  struct Request {
-    u64 reqId;
-    u32 tokens;
-    f64 rate;
-  };
-  struct Response {
-    u64 reqId;
-    u32 tokens;
-    f64 rateReq;
-    f64 givenRate;
-  };
+template <typename Queuing>
+class DistSender : public Sender<DistSender<Queuing>, Queuing> {
+ private:
+  typedef Sender<DistSender<Queuing>, Queuing> Base;
+  friend Base;
 
+ public:
   DistSender(des::Simulator* _sim, const std::string& _name,
-             const des::Model* _parent, u32 _id, const std::string& _queuing,
-             Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
-             u32 _receiverMinId, u32 _receiverMaxId, f64 _rateLimit,
-             Json::Value _settings);
+             const des::Model* _parent, u32 _id, Network* _network,
+             u32 _minMessageSize, u32 _maxMessageSize, u32 _receiverMinId,
+             u32 _receiverMaxId, f64 _rateLimit,
+             const SenderConfig* _config);
   ~DistSender();
   void distIds(u32 _distMinId, u32 _distMaxId);
 
-  void recv(Message* _msg) override;
+  void recv(Message* _msg);
+  u64 queued() const override;
+
+  // this reports the current state for sampling
+  void sample(u32* _tokens, f64* _rate, u64* _queueSize,
+              u32* _outstanding) const;
+
+  using Base::id;
+  using Base::debug;
 
  protected:
-  void sendMessage(Message* _msg) override;
+  using Base::simulator;
+  using Base::prng;
+  using Base::send;
+  using Base::nodeClass_;
+  using Base::minMessageSize;
+  using Base::maxMessageSize;
+
+  void sendMessage(Message* _msg);
 
  private:
   // this handles steal requests
@@ -76,8 +86,8 @@ class DistSender : public Sender {
   // this handles steal responses
   void recvResponse(Message* _msg);
 
-  // this handles waiting events to send another message
-  void handle_wait(des::Event* _event);
+  // this handles the wake-up to send another message
+  void wakeUp();
 
   // this processes the send queue
   void processQueue();
@@ -104,28 +114,12 @@ class DistSender : public Sender {
   // this adds the specified rate value to this sender's rate
   void addRate(f64 _rate);
 
-  // DEBUG - print some stats
-  void showStats(des::Event* _event);
-
   const f64 distRate_;
   u32 distMinId_;
   u32 distMaxId_;
-
-  // common parameters
-  const u32 maxTokens_;  // bucket size
-
-  // stealing parameters
-  const bool stealTokens_;
-  const bool stealRate_;
-  const f64 stealThreshold_;  // bucket percentage
-  const f64 tokenAskFactor_;  // bucket percentage of not filled portion
-  const f64 rateAskFactor_;  // percentage of not used rate to 1.0 div by reqs
-  const u32 maxRequestsOutstanding_;
-
-  // giving parameters
-  const f64 giveTokenThreshold_;  // bucket percentage
-  const f64 giveRateThreshold_;  // bucket percentage
-  const f64 giveRateFactor_;
+  const SenderConfig* config_;  // the parameters, shared by all senders
+  PeerSelector* peerSelector_;
+  std::vector<u32> peers_;  // scratch space for the selected peers
 
   u64 distReqId_;
   f64 rate_;
@@ -134,11 +128,13 @@ class DistSender : public Sender {
 
   f64 rateAsked_;  // this keeps track of how much we've asked for
 
-  std::queue<Message*> sendQueue_;
+  MessageFifo sendQueue_;
   u64 queueSize_;
 
   u32 requestsOutstanding_;
-  bool waiting_;
+  Timer waitTimer_;
 };
 
+#include "ratecontrol/DistSender.tcc"
+
 #endif  // RATECONTROL_DISTSENDER_H_
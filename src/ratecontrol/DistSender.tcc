@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_DISTSENDER_H_
+#error "do not include this file, include DistSender.h instead"
+#endif  // RATECONTROL_DISTSENDER_H_
+
+#include <cassert>
+
+#include <algorithm>
+#include <typeinfo>
+
+#include "ratecontrol/MemoryStats.h"
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Profiler.h"
+
+template <typename Queuing>
+DistSender<Queuing>::DistSender(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
+    u32 _receiverMinId, u32 _receiverMaxId, f64 _rateLimit,
+    const SenderConfig* _config)
+    : Base(_sim, _name, _parent, _id, _network, _minMessageSize,
+           _maxMessageSize, _receiverMinId, _receiverMaxId),
+      distRate_(_rateLimit),
+      config_(_config),
+      peerSelector_(nullptr),
+      // init FSMs
+      distReqId_(0),
+      tokens_(config_->maxTokens),
+      lastTick_(0),
+      rateAsked_(0.0),
+      queueSize_(0),
+      requestsOutstanding_(0),
+      waitTimer_(this, static_cast<Timer::Handler>(&DistSender::wakeUp)) {
+  // the settings are verified by SenderConfig
+}
+
+template <typename Queuing>
+DistSender<Queuing>::~DistSender() {
+  delete peerSelector_;
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::distIds(u32 _distMinId, u32 _distMaxId) {
+  distMinId_ = _distMinId;
+  distMaxId_ = _distMaxId;
+  u32 totalDistSenders = distMaxId_ - distMinId_ + 1;
+  rate_ = distRate_ / totalDistSenders;
+  assert(rate_ > 0.0 && rate_ <= 1.0);
+  assert(config_->maxRequestsOutstanding <= totalDistSenders - 1);
+
+  delete peerSelector_;
+  peerSelector_ = PeerSelector::create(config_->peerSelection, id, distMinId_,
+                                       distMaxId_, &prng);
+  assert(peerSelector_ != nullptr);
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::recv(Message* _msg) {
+  if (_msg->type == Message::DIST_REQUEST) {
+    recvRequest(_msg);
+  } else if (_msg->type == Message::DIST_RESPONSE) {
+    recvResponse(_msg);
+  } else {
+    assert(false);
+  }
+}
+
+template <typename Queuing>
+u64 DistSender<Queuing>::queued() const {
+  return Base::queued() + sendQueue_.size();
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::sample(u32* _tokens, f64* _rate, u64* _queueSize,
+                                 u32* _outstanding) const {
+  // this doesn't advance the bucket, the sampler must not modify the sender
+  des::Tick now = simulator->time().tick;
+  f64 tokens = tokens_;
+  if (now > lastTick_) {
+    tokens = std::min(tokens + (now - lastTick_) * rate_,
+                      (f64)config_->maxTokens);
+  }
+  *_tokens = (u32)tokens;
+  *_rate = rate_;
+  *_queueSize = queueSize_;
+  *_outstanding = requestsOutstanding_;
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::sendMessage(Message* _msg) {
+  // add to queue
+  sendQueue_.push(_msg);
+  queueSize_ += _msg->size;
+  MemoryStats::push(nodeClass_, _msg->size);
+
+  // process the send queue
+  processQueue();
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::recvRequest(Message* _msg) {
+  assert(_msg->size == 1);
+
+  // copy the request out, the response is written into the same message
+  const DistRequest req = *_msg->distRequest();
+  DistResponse res;
+
+  dlogf("recvd steal request %lu from %u for %u tokens and %f rate",
+        req.reqId, _msg->src, req.tokens, req.rate);
+  assert(req.tokens > 0 || req.rate > 0.0);
+
+  // request id
+  res.reqId = req.reqId;
+
+  // make sure we don't give anything if we are stealing
+  u32 tokens = getTokens();
+  if (requestsOutstanding_ > 0) {  // TODO(nicmcd): try without this!
+    tokens = 0;
+  }
+
+  // give tokens as requested and available above token threshold
+  u32 giveTokens = 0;
+  u32 giveTokenTrigger =
+      (u32)(config_->giveTokenThreshold * config_->maxTokens);
+  if (tokens >= giveTokenTrigger) {
+    giveTokens = tokens - giveTokenTrigger;  // only give excess tokens
+  }
+
+  // remove token being given away
+  res.tokens = std::min(giveTokens, req.tokens);
+  removeTokens(res.tokens);
+
+  // give rate as requested and available above rate threshold
+  res.rateReq = req.rate;
+  f64 giveRateTrigger = config_->giveRateThreshold * config_->maxTokens;
+  if ((req.rate > 0.0) && (tokens >= giveRateTrigger)) {
+    // determine the give rate
+    res.givenRate = removeRate(config_->giveRateFactor, req.rate);
+  } else {
+    res.givenRate = 0.0;
+  }
+
+  // reverse the message back to the requester
+  u32 tmp = _msg->src;
+  _msg->src = _msg->dst;
+  _msg->dst = tmp;
+  _msg->type = Message::DIST_RESPONSE;
+  *_msg->distResponse() = res;
+
+  // send the response
+  send(_msg);
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::recvResponse(Message* _msg) {
+  // update the current number of tokens (REQUIRED!)
+  getTokens();
+
+  assert(_msg->size == 1);
+
+  // consume the stolen values
+  const DistResponse* res = _msg->distResponse();
+  dlogf("recvd steal response %lu from %u for %u tokens and %f rate (%f)",
+        res->reqId, _msg->src, res->tokens, res->givenRate, res->rateReq);
+  addTokens(res->tokens);
+  addRate(res->givenRate);
+  peerSelector_->feedback(_msg->src, res->tokens > 0 || res->givenRate > 0.0);
+  rateAsked_ -= res->rateReq;
+
+  // cleanup
+  delete _msg;
+
+  // process the send queue
+  assert(requestsOutstanding_ > 0);
+  requestsOutstanding_--;
+  processQueue();
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::wakeUp() {
+  static const u32 SITE = Profiler::site(typeid(DistSender), "wakeUp");
+  ProfileProbe probe(SITE);
+  processQueue();
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::processQueue() {
+  // this and processSteal() are sites of their own as the send, response and
+  //  wake-up handlers all reach them, so the profile separates the sending
+  //  and stealing from the handling of each event
+  static const u32 SITE = Profiler::site(typeid(DistSender), "processQueue");
+  ProfileProbe probe(SITE);
+
+  // see if steal requests need to be sent
+  processSteal();
+
+  // send all messages that we have tokens for
+  while (!sendQueue_.empty()) {
+    // get the current token count
+    u32 tokens = getTokens();
+
+    // peek at the next message
+    Message* msg = sendQueue_.front();
+
+    // try to send the message
+    if (tokens >= msg->size) {
+      dlogf("sending a message");
+      // send the message
+      send(msg);
+
+      // remove the used tokens
+      removeTokens(msg->size);
+
+      // remove the sent message from the queue
+      sendQueue_.pop();
+      queueSize_ -= msg->size;
+      MemoryStats::pop(nodeClass_, msg->size);
+
+      // we might need steal requests now
+      processSteal();
+    } else {
+      // can't send the message, wait for tokens to arrive. a pending wake-up
+      //  is moved earlier when tokens or rate were gained, a wake-up that is
+      //  too early recomputes when it fires.
+      des::Tick tokensNeeded = msg->size - tokens;
+      des::Time wakeUp = simulator->time();
+      wakeUp += (u64)(tokensNeeded / std::max(0.001, getRate()));
+      assert(wakeUp != simulator->time());
+      if (!waitTimer_.armed() || wakeUp < waitTimer_.time()) {
+        dlogf("creating wait period");
+        waitTimer_.set(wakeUp);
+      }
+      return;
+    }
+  }
+
+  // nothing left to wait for
+  waitTimer_.cancel();
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::processSteal() {
+  static const u32 SITE = Profiler::site(typeid(DistSender), "processSteal");
+  ProfileProbe probe(SITE);
+
+  // get the current token count
+  u32 tokens = getTokens();
+
+  // conditions for stealing
+  bool lowWaterTrigger =
+      tokens < (config_->stealThreshold * config_->maxTokens);
+  bool canStealTokens = config_->stealTokens && (tokens < config_->maxTokens);
+  bool canStealRate = config_->stealRate && ((getRate() + rateAsked_) < 0.9999);
+  bool stealsAvailable = requestsOutstanding_ < config_->maxRequestsOutstanding;
+
+  if ((canStealTokens || canStealRate) &&
+      stealsAvailable && lowWaterTrigger) {
+    /*
+    // if enabled and needed, issue steal requests
+    if ((config_->stealTokens || (config_->stealRate && getRate() < 1.0)) &&
+      (requestsOutstanding_ < config_->maxRequestsOutstanding) &&
+      (tokens <= (config_->stealThreshold * config_->maxTokens))) {
+    */
+
+    // choose the destination peers
+    distReqId_++;
+    u32 numReqs = config_->maxRequestsOutstanding - requestsOutstanding_;
+    peers_.clear();
+    peerSelector_->select(numReqs, &peers_);
+
+    // issue all available steal requests
+    for (u32 rr = 0; rr < numReqs; rr++) {
+      u32 peer = peers_[rr];
+      assert(peer != id);
+
+      // create and format the steal request message
+      Message* msg = new Message(id, peer, 1, 0, Message::DIST_REQUEST,
+                                 simulator->time().tick);
+      DistRequest* req = msg->distRequest();
+      req->reqId = 0x1000000000000000lu | ((u64)id << 32) | distReqId_;
+
+      // request enough tokens for the whole queue
+      u32 askTokens = (u32)(((1.0 / config_->maxRequestsOutstanding)
+                             * config_->tokenAskFactor)
+                            * (config_->maxTokens - tokens));
+      req->tokens = config_->stealTokens ? askTokens : 0;
+
+      // divide the remaining rate by number of requests incase all the
+      //  responders say yes. we can only have a total of 1.0 rate
+      f64 askRate = ((1.0 - getRate() - rateAsked_) * config_->rateAskFactor)
+          / numReqs;
+      req->rate = config_->stealRate ? askRate : 0.0;
+      rateAsked_ += askRate;
+      assert(getRate() + rateAsked_ < 1.00001);
+
+      assert(req->tokens > 0 || req->rate > 0.0);
+
+      // send the request message
+      send(msg);
+
+      // increment the requests outstanding counter
+      requestsOutstanding_++;
+
+      dlogf("sent steal request %lu to %u for %u tokens and %f rate",
+            req->reqId, peer, req->tokens, req->rate);
+    }
+  }
+}
+
+template <typename Queuing>
+u32 DistSender<Queuing>::getTokens() {
+  des::Tick now = simulator->time().tick;
+  if (now > lastTick_) {
+    tokens_ += ((now - lastTick_) * rate_);
+    tokens_ = std::min(tokens_, (f64)config_->maxTokens);
+    lastTick_ = now;
+  }
+  return (u32)tokens_;
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::addTokens(u32 _tokens) {
+  tokens_ += _tokens;
+  tokens_ = std::min(tokens_, (f64)config_->maxTokens);
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::removeTokens(u32 _tokens) {
+  tokens_ -= _tokens;
+  assert(tokens_ >= 0.0);
+}
+
+template <typename Queuing>
+f64 DistSender<Queuing>::getRate() const {
+  return std::min(1.0, rate_);
+}
+
+template <typename Queuing>
+f64 DistSender<Queuing>::removeRate(f64 _factor, f64 _max) {
+  assert(_factor >= 0.0 && _factor <= 1.0);
+  f64 take = std::min(_factor * rate_, _max);
+  rate_ -= take;
+  assert(rate_ >= 0.0);
+  return take;
+}
+
+template <typename Queuing>
+void DistSender<Queuing>::addRate(f64 _rate) {
+  assert(_rate >= 0.0);
+  rate_ += _rate;
+  assert(rate_ >= 0.0);  // not needed?
+}
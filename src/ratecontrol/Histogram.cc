@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/Histogram.h"
+
+#include <cassert>
+
+static const u64 SUBS = 1lu << Histogram::PRECISION;
+
+Histogram::Histogram()
+    : count_(0) {}
+
+Histogram::~Histogram() {}
+
+void Histogram::add(u64 _value) {
+  u64 idx = index(_value);
+  if (idx >= buckets_.size()) {
+    buckets_.resize(idx + 1, 0);
+  }
+  buckets_[idx]++;
+  count_++;
+}
+
+void Histogram::merge(const Histogram& _other) {
+  if (_other.buckets_.size() > buckets_.size()) {
+    buckets_.resize(_other.buckets_.size(), 0);
+  }
+  for (u64 idx = 0; idx < _other.buckets_.size(); idx++) {
+    buckets_[idx] += _other.buckets_[idx];
+  }
+  count_ += _other.count_;
+}
+
+u64 Histogram::count() const {
+  return count_;
+}
+
+u64 Histogram::percentile(f64 _percentile) const {
+  assert(_percentile > 0.0 && _percentile < 1.0);
+  assert(count_ > 0);
+  u64 rank = (u64)(count_ * _percentile);  // zero based
+  u64 seen = 0;
+  for (u64 idx = 0; idx < buckets_.size(); idx++) {
+    seen += buckets_[idx];
+    if (seen > rank) {
+      return highest(idx);
+    }
+  }
+  assert(false);
+  return 0;
+}
+
+u64 Histogram::index(u64 _value) {
+  if (_value < 2 * SUBS) {
+    return _value;
+  }
+  u32 msb = 63 - __builtin_clzl(_value);
+  u32 shift = msb - PRECISION;
+  return (shift * SUBS) + (_value >> shift);
+}
+
+u64 Histogram::highest(u64 _index) {
+  if (_index < 2 * SUBS) {
+    return _index;
+  }
+  u64 shift = (_index / SUBS) - 1;
+  u64 sub = (_index % SUBS) + SUBS;
+  return ((sub + 1) << shift) - 1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_HISTOGRAM_H_
+#define RATECONTROL_HISTOGRAM_H_
+
+#include <prim/prim.h>
+
+#include <vector>
+
+/*
+ * This is a log-bucketed (HDR style) histogram of non-negative integers.
+ *  Values below 2^(PRECISION+1) are recorded exactly, larger values are
+ *  recorded with a relative error below 2^-PRECISION. Memory grows with the
+ *  magnitude of the largest value, not the number of samples.
+ */
+class Histogram {
+ public:
+  Histogram();
+  ~Histogram();
+
+  void add(u64 _value);
+  void merge(const Histogram& _other);
+  u64 count() const;
+
+  /*
+   * This returns the sample at the specified percentile (0.0 < p < 1.0)
+   *  using the same ranking as the offline parser: the (floor(n * p) + 1)th
+   *  smallest sample. The highest value equivalent to the sample's bucket is
+   *  returned.
+   */
+  u64 percentile(f64 _percentile) const;
+
+  static const u32 PRECISION = 10;
+
+ private:
+  static u64 index(u64 _value);
+  static u64 highest(u64 _index);
+
+  u64 count_;
+  std::vector<u64> buckets_;
+};
+
+#endif  // RATECONTROL_HISTOGRAM_H_
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <prim/prim.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "ratecontrol/Histogram.h"
+
+namespace {
+
+const f64 PERCENTILES[] = {0.01, 0.25, 0.5, 0.9, 0.99, 0.999, 0.9999};
+
+// this is parser/parser.py's ranking: the (floor(n * p) + 1)th smallest sample
+u64 reference(std::vector<u64> _samples, f64 _percentile) {
+  std::sort(_samples.begin(), _samples.end());
+  return _samples.at((u64)(_samples.size() * _percentile));
+}
+
+}  // namespace
+
+TEST(Histogram, exact) {
+  // values below 2^(PRECISION+1) are recorded exactly
+  const u64 LIMIT = 2lu << Histogram::PRECISION;
+  std::mt19937_64 prng(12345);
+  for (u64 samples : {1lu, 2lu, 3lu, 10lu, 999lu, 1000lu, 12345lu}) {
+    Histogram hist;
+    std::vector<u64> values;
+    for (u64 idx = 0; idx < samples; idx++) {
+      u64 value = prng() % LIMIT;
+      hist.add(value);
+      values.push_back(value);
+    }
+    ASSERT_EQ(hist.count(), samples);
+    for (f64 p : PERCENTILES) {
+      ASSERT_EQ(hist.percentile(p), reference(values, p))
+          << "samples=" << samples << " p=" << p;
+    }
+  }
+}
+
+TEST(Histogram, relativeError) {
+  // larger values are reported as the highest value of their bucket
+  std::mt19937_64 prng(54321);
+  Histogram hist;
+  std::vector<u64> values;
+  for (u64 idx = 0; idx < 100000; idx++) {
+    u64 value = prng() >> (prng() % 60);
+    hist.add(value);
+    values.push_back(value);
+  }
+  for (f64 p : PERCENTILES) {
+    u64 exact = reference(values, p);
+    u64 approx = hist.percentile(p);
+    ASSERT_GE(approx, exact) << "p=" << p;
+    ASSERT_LE(approx - exact, exact >> Histogram::PRECISION) << "p=" << p;
+  }
+}
+
+TEST(Histogram, bucketBoundaries) {
+  // a single sample is reported as the top of its bucket, the buckets are
+  //  contiguous around each power of two
+  for (u32 bit = Histogram::PRECISION; bit < 63; bit++) {
+    for (s64 offset = -2; offset <= 2; offset++) {
+      u64 value = (1lu << bit) + offset;
+      Histogram hist;
+      hist.add(value);
+      u64 top = hist.percentile(0.5);
+      ASSERT_GE(top, value);
+      ASSERT_LE(top - value, value >> Histogram::PRECISION);
+
+      // the top of a bucket belongs to that bucket
+      Histogram again;
+      again.add(top);
+      ASSERT_EQ(again.percentile(0.5), top);
+    }
+  }
+}
+
+TEST(Histogram, merge) {
+  std::mt19937_64 prng(999);
+  Histogram all;
+  Histogram parts[3];
+  for (u64 idx = 0; idx < 30000; idx++) {
+    u64 value = prng() % 100000;
+    all.add(value);
+    parts[idx % 3].add(value);
+  }
+  Histogram merged;
+  for (const Histogram& part : parts) {
+    merged.merge(part);
+  }
+  ASSERT_EQ(merged.count(), all.count());
+  for (f64 p : PERCENTILES) {
+    ASSERT_EQ(merged.percentile(p), all.percentile(p));
+  }
+}
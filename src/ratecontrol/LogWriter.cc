@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/LogWriter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+LogWriter::LogWriter(const std::string& _filename)
+    : filename_(_filename) {
+  // the fastest level keeps up with a verbose simulation, the default level
+  //  compresses about 3x slower and would throttle it
+  file_ = gzopen(filename_.c_str(), "wb1");
+  if (file_ == nullptr) {
+    fprintf(stderr, "couldn't open log file: %s\n", filename_.c_str());
+    exit(-1);
+  }
+  gzbuffer(file_, CHUNK * 4);
+
+  s32 fds[2];
+  if (pipe(fds) != 0) {
+    fprintf(stderr, "couldn't create the log pipe\n");
+    exit(-1);
+  }
+  readFd_ = fds[0];
+  writeFd_ = fds[1];
+#ifdef F_SETPIPE_SZ
+  // a larger pipe lets the simulation run ahead of the compression
+  fcntl(writeFd_, F_SETPIPE_SZ, 1 << 20);
+#endif
+  path_ = "/dev/fd/" + std::to_string(writeFd_);
+
+  thread_ = std::thread(&LogWriter::run, this);
+}
+
+LogWriter::~LogWriter() {
+  close();
+}
+
+const std::string& LogWriter::path() const {
+  return path_;
+}
+
+void LogWriter::close() {
+  if (!thread_.joinable()) {
+    return;
+  }
+
+  // the thread sees the end of the pipe once all writers closed it
+  ::close(writeFd_);
+  thread_.join();
+  ::close(readFd_);
+  if (gzclose(file_) != Z_OK) {
+    fprintf(stderr, "couldn't write log file: %s\n", filename_.c_str());
+    exit(-1);
+  }
+}
+
+void LogWriter::run() {
+  std::vector<char> chunk(CHUNK);
+  while (true) {
+    ssize_t bytes = read(readFd_, chunk.data(), chunk.size());
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes < 0) {
+      fprintf(stderr, "couldn't read the log pipe\n");
+      exit(-1);
+    }
+    if (bytes == 0) {
+      return;
+    }
+    if (gzwrite(file_, chunk.data(), bytes) != bytes) {
+      fprintf(stderr, "couldn't write log file: %s\n", filename_.c_str());
+      exit(-1);
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_LOGWRITER_H_
+#define RATECONTROL_LOGWRITER_H_
+
+#include <prim/prim.h>
+#include <zlib.h>
+
+#include <string>
+#include <thread>
+
+/*
+ * This compresses the simulation log in a background thread so compression
+ *  and file I/O overlap the simulation. The des::Logger writes the plain log
+ *  into a pipe (see path()) and this writes it through zlib to a gzip file,
+ *  the decompressed content is exactly what the logger wrote.
+ */
+class LogWriter {
+ public:
+  explicit LogWriter(const std::string& _filename);
+  ~LogWriter();
+
+  /*
+   * This is the path the des::Logger must open instead of the log file.
+   */
+  const std::string& path() const;
+
+  /*
+   * This waits for the remaining log to be compressed and closes the file.
+   *  The des::Logger must be deleted before this is called.
+   */
+  void close();
+
+  static const u32 CHUNK = 1 << 16;
+
+ private:
+  void run();
+
+  const std::string filename_;
+  std::string path_;
+  s32 readFd_;
+  s32 writeFd_;
+  gzFile file_;
+  std::thread thread_;
+};
+
+#endif  // RATECONTROL_LOGWRITER_H_
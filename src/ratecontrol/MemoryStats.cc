@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/MemoryStats.h"
+
+#include <sstream>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Node.h"
+#include "ratecontrol/Pool.h"
+
+namespace {
+
+const char* CLASS_NAMES[] = {"Sender", "Receiver", "Relay"};
+
+void leak(std::stringstream* _ss, const std::string& _name, s64 _live) {
+  if (_live != 0) {
+    *_ss << "Leaked " << _name << ": " << _live << '\n';
+  }
+}
+
+// the counters have a single writer, a relaxed load and store suffice
+void add(std::atomic<s64>* _counter, s64 _value) {
+  _counter->store(_counter->load(std::memory_order_relaxed) + _value,
+                  std::memory_order_relaxed);
+}
+
+void maximize(std::atomic<s64>* _peak, s64 _value) {
+  if (_value > _peak->load(std::memory_order_relaxed)) {
+    _peak->store(_value, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+thread_local MemoryStats::Counters* MemoryStats::counters_ = nullptr;
+
+void MemoryStats::push(Bandwidth::NodeClass _class, u32 _size) {
+  Counter& c = counters()->classes[_class];
+  add(&c.messages, 1);
+  add(&c.bytes, _size);
+  maximize(&c.peakMessages, c.messages.load(std::memory_order_relaxed));
+  maximize(&c.peakBytes, c.bytes.load(std::memory_order_relaxed));
+}
+
+void MemoryStats::pop(Bandwidth::NodeClass _class, u32 _size) {
+  Counter& c = counters()->classes[_class];
+  add(&c.messages, -1);
+  add(&c.bytes, -(s64)_size);
+}
+
+MemoryStats::Queued MemoryStats::queued(Bandwidth::NodeClass _class) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  Queued s = {0, 0, 0, 0};
+  for (const Counters* c : reg.counters) {
+    const Counter& k = c->classes[_class];
+    s.messages += k.messages.load(std::memory_order_relaxed);
+    s.peakMessages += k.peakMessages.load(std::memory_order_relaxed);
+    s.bytes += k.bytes.load(std::memory_order_relaxed);
+    s.peakBytes += k.peakBytes.load(std::memory_order_relaxed);
+  }
+  return s;
+}
+
+std::string MemoryStats::toString() {
+  std::stringstream ss;
+  for (u32 c = 0; c < Bandwidth::NUM_CLASSES; c++) {
+    Queued q = queued((Bandwidth::NodeClass)c);
+    ss << CLASS_NAMES[c] << " queue messages: " << q.messages << '\n'
+       << CLASS_NAMES[c] << " queue peak messages: " << q.peakMessages << '\n'
+       << CLASS_NAMES[c] << " queue bytes: " << q.bytes << '\n'
+       << CLASS_NAMES[c] << " queue peak bytes: " << q.peakBytes << '\n';
+  }
+  return ss.str();
+}
+
+std::string MemoryStats::leaks() {
+  std::stringstream ss;
+  leak(&ss, "Message", Pool<Message>::stats().live);
+  leak(&ss, "MessageEvent", Pool<MessageEvent>::stats().live);
+  leak(&ss, "NodeEvent", Pool<NodeEvent>::stats().live);
+  leak(&ss, "TimerEvent", Pool<TimerEvent>::stats().live);
+  for (u32 c = 0; c < Bandwidth::NUM_CLASSES; c++) {
+    leak(&ss, std::string(CLASS_NAMES[c]) + " queue messages",
+         queued((Bandwidth::NodeClass)c).messages);
+  }
+  return ss.str();
+}
+
+MemoryStats::Registry::~Registry() {
+  for (Counters* c : counters) {
+    delete c;
+  }
+}
+
+MemoryStats::Counters* MemoryStats::counters() {
+  if (counters_ == nullptr) {
+    // the counters are owned by the registry so they outlive the thread
+    Counters* c = new Counters();
+    for (Counter& k : c->classes) {
+      k.messages.store(0, std::memory_order_relaxed);
+      k.peakMessages.store(0, std::memory_order_relaxed);
+      k.bytes.store(0, std::memory_order_relaxed);
+      k.peakBytes.store(0, std::memory_order_relaxed);
+    }
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.counters.push_back(c);
+    counters_ = c;
+  }
+  return counters_;
+}
+
+MemoryStats::Registry& MemoryStats::registry() {
+  static Registry reg;
+  return reg;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_MEMORYSTATS_H_
+#define RATECONTROL_MEMORYSTATS_H_
+
+#include <prim/prim.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ratecontrol/Bandwidth.h"
+
+/*
+ * This accounts the messages held in node queues (egress ports and the send
+ *  queues of senders) per class of node, and checks that all pooled objects
+ *  were freed at the end of a run. Like the pools, each thread counts in its
+ *  own counters without locking, so peaks are exact with a single thread and
+ *  bound the true peak from above otherwise.
+ */
+class MemoryStats {
+ public:
+  struct Queued {
+    s64 messages;
+    s64 peakMessages;
+    s64 bytes;
+    s64 peakBytes;
+  };
+
+  /*
+   * These account a message entering and leaving a queue.
+   */
+  static void push(Bandwidth::NodeClass _class, u32 _size);
+  static void pop(Bandwidth::NodeClass _class, u32 _size);
+
+  static Queued queued(Bandwidth::NodeClass _class);
+
+  /*
+   * This formats the queue accounting of all classes.
+   */
+  static std::string toString();
+
+  /*
+   * This lists the pooled objects and queued messages that are still live.
+   *  It is empty when everything was freed, thus it must be called after all
+   *  nodes were deleted.
+   */
+  static std::string leaks();
+
+ private:
+  // these are atomic as queued() may run on another thread (i.e., the
+  //  progress reporter), only the owning thread writes them
+  struct Counter {
+    std::atomic<s64> messages;
+    std::atomic<s64> peakMessages;
+    std::atomic<s64> bytes;
+    std::atomic<s64> peakBytes;
+  };
+
+  struct Counters {
+    Counter classes[Bandwidth::NUM_CLASSES];
+  };
+
+  struct Registry {
+    ~Registry();
+    std::mutex lock;
+    std::vector<Counters*> counters;
+  };
+
+  static Counters* counters();
+  static Registry& registry();
+
+  static thread_local Counters* counters_;
+};
+
+#endif  // RATECONTROL_MEMORYSTATS_H_
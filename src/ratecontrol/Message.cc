@@ -30,27 +30,57 @@
  */
 #include "ratecontrol/Message.h"
 
-#include <sstream>
+#include <cassert>
+#include <cstdio>
+
+#include "ratecontrol/ProgressReporter.h"
+
+static_assert(sizeof(Message) <= 64, "Message must fit in a cache line");
 
 Message::Message(u32 _src, u32 _dst, u32 _size, u64 _trans, u8 _type,
-                 void* _data, u64 _priority)
-    : src(_src), dst(_dst), size(_size), trans(_trans), type(_type),
-      data(_data), priority(_priority) {}
+                 u64 _priority)
+    : trans(_trans), priority(_priority), src(_src), dst(_dst), size(_size),
+      type(_type) {}
 
 Message::~Message() {}
 
+RelayRequest* Message::relayRequest() {
+  assert(type == RELAY_REQUEST);
+  return &payload_.relayRequest_;
+}
+
+RelayResponse* Message::relayResponse() {
+  assert(type == RELAY_RESPONSE);
+  return &payload_.relayResponse_;
+}
+
+DistRequest* Message::distRequest() {
+  assert(type == DIST_REQUEST);
+  return &payload_.distRequest_;
+}
+
+DistResponse* Message::distResponse() {
+  assert(type == DIST_RESPONSE);
+  return &payload_.distResponse_;
+}
+
 std::string Message::toString() const {
-  std::stringstream ss;
-  ss << "src=" << src << " dst=" << dst << " size=" << size <<
-      " trans=" << trans << " type=" << (u64)type << " data*=" << (u64)data;
-  return ss.str();
+  // this is called for every logged message, so it avoids the stream
+  //  machinery
+  char buffer[96];
+  s32 len = snprintf(buffer, sizeof(buffer),
+                     "src=%u dst=%u size=%u trans=%lu type=%u", src, dst, size,
+                     trans, (u32)type);
+  return std::string(buffer, len);
 }
 
 MessageEvent::MessageEvent(des::Model* _model, des::EventHandler _handler,
                            des::Time _time, Message* _msg)
     : des::Event(_model, _handler, _time), msg(_msg) {}
 
-MessageEvent::~MessageEvent() {}
+MessageEvent::~MessageEvent() {
+  ProgressReporter::executed(time.tick);
+}
 
 bool MessagePriorityComparator::operator()(const Message* _lhs,
                                            const Message* _rhs) const {
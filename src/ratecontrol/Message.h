@@ -36,19 +36,47 @@
 
 #include <string>
 
-class Message {
+#include "ratecontrol/Pool.h"
+
+/*
+ * These are the control payloads carried inline within a Message. The active
+ *  payload is selected by the message type.
+ */
+struct RelayRequest {
+  u64 reqId;
+  u32 msgDst;
+};
+
+struct RelayResponse {
+  u64 reqId;
+};
+
+struct DistRequest {
+  u64 reqId;
+  f64 rate;
+  u32 tokens;
+};
+
+struct DistResponse {
+  u64 reqId;
+  f64 rateReq;
+  f64 givenRate;
+  u32 tokens;
+};
+
+class Message : public Pooled<Message> {
  public:
-  Message(u32 _src, u32 _dst, u32 _size, u64 _trans, u8 _type, void* _data,
+  Message(u32 _src, u32 _dst, u32 _size, u64 _trans, u8 _type,
           u64 _priority);
   ~Message();
 
+  // header (the wide fields go first to avoid padding)
+  u64 trans;
+  u64 priority;
   u32 src;
   u32 dst;
   u32 size;
-  u64 trans;
   u8 type;
-  void* data;
-  u64 priority;
 
   static const u8 PLAIN = 0;
   static const u8 RELAY_REQUEST = 1;
@@ -56,10 +84,24 @@ class Message {
   static const u8 DIST_REQUEST = 3;
   static const u8 DIST_RESPONSE = 4;
 
+  // typed access to the payload, the type must match
+  RelayRequest* relayRequest();
+  RelayResponse* relayResponse();
+  DistRequest* distRequest();
+  DistResponse* distResponse();
+
   std::string toString() const;
+
+ private:
+  union {
+    RelayRequest relayRequest_;
+    RelayResponse relayResponse_;
+    DistRequest distRequest_;
+    DistResponse distResponse_;
+  } payload_;
 };
 
-class MessageEvent : public des::Event {
+class MessageEvent : public des::Event, public Pooled<MessageEvent> {
  public:
   MessageEvent(des::Model* _model, des::EventHandler _handler, des::Time _time,
                Message* _msg);
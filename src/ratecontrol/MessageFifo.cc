@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/MessageFifo.h"
+
+#include <cassert>
+
+MessageFifo::MessageFifo()
+    : buffer_(nullptr), capacity_(0), head_(0), size_(0) {}
+
+MessageFifo::~MessageFifo() {
+  delete[] buffer_;
+}
+
+void MessageFifo::push(Message* _msg) {
+  u32 size = size_.load(std::memory_order_relaxed);
+  if (size == capacity_) {
+    grow();
+  }
+  buffer_[(head_ + size) & (capacity_ - 1)] = _msg;
+  size_.store(size + 1, std::memory_order_relaxed);
+}
+
+Message* MessageFifo::front() const {
+  assert(size() > 0);
+  return buffer_[head_];
+}
+
+void MessageFifo::pop() {
+  u32 size = size_.load(std::memory_order_relaxed);
+  assert(size > 0);
+  head_ = (head_ + 1) & (capacity_ - 1);
+  size_.store(size - 1, std::memory_order_relaxed);
+}
+
+bool MessageFifo::empty() const {
+  return size() == 0;
+}
+
+u32 MessageFifo::size() const {
+  return size_.load(std::memory_order_relaxed);
+}
+
+void MessageFifo::grow() {
+  // double the capacity and unwrap the contents to the start of the buffer
+  u32 capacity = capacity_ == 0 ? 4 : capacity_ * 2;
+  Message** buffer = new Message*[capacity];
+  u32 size = size_.load(std::memory_order_relaxed);
+  for (u32 idx = 0; idx < size; idx++) {
+    buffer[idx] = buffer_[(head_ + idx) & (capacity_ - 1)];
+  }
+  delete[] buffer_;
+  buffer_ = buffer;
+  capacity_ = capacity;
+  head_ = 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_MESSAGEFIFO_H_
+#define RATECONTROL_MESSAGEFIFO_H_
+
+#include <prim/prim.h>
+
+#include <atomic>
+
+class Message;
+
+/*
+ * This is a FIFO of messages in a growable ring buffer. Unlike std::queue
+ *  (a std::deque), an empty FIFO owns no memory, the buffer is allocated on
+ *  the first push. Most nodes never queue anything so this keeps them small.
+ *  size() may be called by other threads (i.e., the progress reporter) while
+ *  the owning thread modifies the FIFO.
+ */
+class MessageFifo {
+ public:
+  MessageFifo();
+  ~MessageFifo();
+  MessageFifo(const MessageFifo&) = delete;
+  MessageFifo& operator=(const MessageFifo&) = delete;
+
+  void push(Message* _msg);
+  Message* front() const;
+  void pop();
+  bool empty() const;
+  u32 size() const;
+
+ private:
+  void grow();
+
+  Message** buffer_;
+  u32 capacity_;  // always a power of 2 (or 0)
+  u32 head_;
+  std::atomic<u32> size_;  // only written by the owning thread
+};
+
+#endif  // RATECONTROL_MESSAGEFIFO_H_
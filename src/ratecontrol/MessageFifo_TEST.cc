@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <prim/prim.h>
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/MessageFifo.h"
+
+namespace {
+
+// the FIFO only stores the pointers, the messages identify themselves by trans
+class MessageFifoTest : public ::testing::Test {
+ protected:
+  ~MessageFifoTest() {
+    for (Message* msg : messages_) {
+      delete msg;
+    }
+  }
+
+  Message* message(u64 _trans) {
+    Message* msg = new Message(0, 1, 1, _trans, Message::PLAIN, 0);
+    messages_.push_back(msg);
+    return msg;
+  }
+
+  std::vector<Message*> messages_;
+};
+
+}  // namespace
+
+TEST_F(MessageFifoTest, empty) {
+  MessageFifo fifo;
+  ASSERT_TRUE(fifo.empty());
+  ASSERT_EQ(fifo.size(), 0u);
+}
+
+TEST_F(MessageFifoTest, growth) {
+  MessageFifo fifo;
+  for (u64 idx = 0; idx < 1000; idx++) {
+    fifo.push(message(idx));
+    ASSERT_EQ(fifo.size(), idx + 1);
+  }
+  for (u64 idx = 0; idx < 1000; idx++) {
+    ASSERT_FALSE(fifo.empty());
+    ASSERT_EQ(fifo.front()->trans, idx);
+    fifo.pop();
+  }
+  ASSERT_TRUE(fifo.empty());
+}
+
+TEST_F(MessageFifoTest, wrapThenGrow) {
+  // the initial capacity is 4, wrap the ring before it grows
+  MessageFifo fifo;
+  u64 pushed = 0;
+  u64 popped = 0;
+  for (u32 idx = 0; idx < 3; idx++) {
+    fifo.push(message(pushed++));
+  }
+  for (u32 idx = 0; idx < 2; idx++) {
+    ASSERT_EQ(fifo.front()->trans, popped++);
+    fifo.pop();
+  }
+  for (u32 idx = 0; idx < 3; idx++) {
+    fifo.push(message(pushed++));  // wraps around the end of the buffer
+  }
+  ASSERT_EQ(fifo.size(), 4u);
+  for (u32 idx = 0; idx < 5; idx++) {
+    fifo.push(message(pushed++));  // grows while wrapped
+  }
+  ASSERT_EQ(fifo.size(), 9u);
+  while (!fifo.empty()) {
+    ASSERT_EQ(fifo.front()->trans, popped++);
+    fifo.pop();
+  }
+  ASSERT_EQ(popped, pushed);
+}
+
+TEST_F(MessageFifoTest, random) {
+  std::mt19937_64 prng(12345);
+  MessageFifo fifo;
+  std::deque<Message*> reference;
+  u64 trans = 0;
+  for (u32 step = 0; step < 100000; step++) {
+    // push slightly more often than pop so the ring grows over time
+    if (reference.empty() || prng() % 100 < 52) {
+      Message* msg = message(trans++);
+      fifo.push(msg);
+      reference.push_back(msg);
+    } else {
+      ASSERT_EQ(fifo.front(), reference.front());
+      fifo.pop();
+      reference.pop_front();
+    }
+    ASSERT_EQ(fifo.size(), reference.size());
+    ASSERT_EQ(fifo.empty(), reference.empty());
+  }
+}
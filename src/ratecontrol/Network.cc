@@ -32,20 +32,36 @@
 
 #include <cassert>
 
-#include <utility>
-
 Network::Network(des::Simulator* _sim, const std::string& _name,
                  const des::Model* _parent, des::Tick _delay)
-    : des::Model(_sim, _name, _parent), delay_(_delay) {}
+    : des::Model(_sim, _name, _parent), delay_(_delay), size_(0) {}
 
 Network::~Network() {}
 
+void Network::reserve(u32 _numNodes) {
+  if (_numNodes > nodes_.size()) {
+    nodes_.resize(_numNodes, {nullptr, delay_});
+  }
+}
+
 void Network::registerNode(u32 _id, Node* _node) {
-  assert(nodes_.insert(std::make_pair(_id, _node)).second);
+  reserve(_id + 1);
+  assert(nodes_[_id].node == nullptr);
+  nodes_[_id].node = _node;
+  size_++;
+}
+
+void Network::registerRange(u32 _first, u32 _count, Node* _node) {
+  reserve(_first + _count);
+  for (u32 id = _first; id < _first + _count; id++) {
+    assert(nodes_[id].node == nullptr);
+    nodes_[id].node = _node;
+  }
+  size_ += _count;
 }
 
 u32 Network::size() const {
-  return nodes_.size();
+  return size_;
 }
 
 des::Tick Network::delay() const {
@@ -53,5 +69,15 @@ des::Tick Network::delay() const {
 }
 
 Node* Network::getNode(u32 _id) const {
-  return nodes_.at(_id);
+  return getEntry(_id).node;
+}
+
+const Network::Entry& Network::getEntry(u32 _id) const {
+  assert(_id < nodes_.size() && nodes_[_id].node != nullptr);
+  return nodes_[_id];
+}
+
+void Network::setDelay(u32 _id, des::Tick _delay) {
+  reserve(_id + 1);
+  nodes_[_id].delay = _delay;
 }
@@ -34,25 +34,61 @@
 #include <des/des.h>
 #include <prim/prim.h>
 
+#include <atomic>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 class Node;
 
+/*
+ * The Network is a directory of nodes indexed directly by node id. Node ids
+ *  are expected to be allocated densely starting at 0.
+ */
 class Network : public des::Model {
  public:
+  /*
+   * This is the per-node hot data used to route a message to a node.
+   */
+  struct Entry {
+    Node* node;
+    des::Tick delay;  // network delay of messages destined to the node
+  };
+
   Network(des::Simulator* _sim, const std::string& _name,
           const des::Model* _parent, des::Tick _delay);
   ~Network();
 
+  /*
+   * This sizes the directory for '_numNodes' nodes in one shot. When called
+   *  before the nodes are created, registration never grows the directory.
+   */
+  void reserve(u32 _numNodes);
+
+  /*
+   * Registration of ids within the reserved size is thread safe.
+   */
   void registerNode(u32 _id, Node* _node);
+
+  /*
+   * This registers one node as ids '_first' through '_first' + '_count' - 1,
+   *  i.e. a node that stands in for a range of nodes. As registerNode(), it
+   *  is thread safe within the reserved size.
+   */
+  void registerRange(u32 _first, u32 _count, Node* _node);
   u32 size() const;
   des::Tick delay() const;
   Node* getNode(u32 _id) const;
+  const Entry& getEntry(u32 _id) const;
+
+  /*
+   * This overrides the network delay of messages destined to a node.
+   */
+  void setDelay(u32 _id, des::Tick _delay);
 
  private:
   des::Tick delay_;
-  std::unordered_map<u32, Node*> nodes_;
+  std::atomic<u32> size_;
+  std::vector<Entry> nodes_;
 };
 
 #endif  // RATECONTROL_NETWORK_H_
@@ -32,21 +32,93 @@
 
 #include <cassert>
 
+#include <typeinfo>
+
 #include "ratecontrol/Message.h"
 #include "ratecontrol/Network.h"
+#include "ratecontrol/Profiler.h"
+#include "ratecontrol/ProgressReporter.h"
+
+NodeEvent::NodeEvent(des::Model* _model, des::EventHandler _handler,
+                     des::Time _time)
+    : des::Event(_model, _handler, _time) {}
+
+NodeEvent::~NodeEvent() {
+  ProgressReporter::executed(time.tick);
+}
+
+Timer::Timer(Node* _node, Handler _handler)
+    : node_(_node), handler_(_handler), armed_(false), live_(false),
+      generation_(0) {}
+
+Timer::~Timer() {}
+
+void Timer::set(des::Time _time) {
+  assert(_time > node_->simulator->time());
+  armed_ = true;
+  target_ = _time;
+
+  // a live event at or before the target is reused
+  if (live_ && liveTime_ <= target_) {
+    return;
+  }
+
+  generation_++;
+  live_ = true;
+  liveTime_ = target_;
+  node_->simulator->addEvent(new TimerEvent(
+      node_, static_cast<des::EventHandler>(&Node::handle_timer), target_,
+      this, generation_));
+}
+
+void Timer::cancel() {
+  armed_ = false;
+}
+
+bool Timer::armed() const {
+  return armed_;
+}
+
+des::Time Timer::time() const {
+  assert(armed_);
+  return target_;
+}
+
+void Timer::expire(u64 _generation) {
+  if (_generation != generation_) {
+    return;  // stale
+  }
+  live_ = false;
+  if (!armed_) {
+    return;  // cancelled
+  }
+  if (node_->simulator->time() < target_) {
+    // moved later, re-arm for the target
+    armed_ = false;
+    set(target_);
+    return;
+  }
+  armed_ = false;
+  (node_->*handler_)();
+}
+
+TimerEvent::TimerEvent(des::Model* _model, des::EventHandler _handler,
+                       des::Time _time, Timer* _timer, u64 _generation)
+    : des::Event(_model, _handler, _time), timer(_timer),
+      generation(_generation) {}
+
+TimerEvent::~TimerEvent() {
+  ProgressReporter::executed(time.tick);
+}
 
 Node::Node(des::Simulator* _sim, const std::string& _name,
-           const des::Model* _parent, u32 _id, const std::string& _queuing,
-           Network* _network)
-    : des::Model(_sim, _name, _parent), id(_id), eventPending_(false),
-      queuing_(_queuing), network_(_network) {
-  // get a random seed (try for truly random)
-  std::random_device rnd;
-  std::uniform_int_distribution<u32> dist;
-  u32 seed = dist(rnd);
-
-  // seed the random number generator
-  prng.seed(seed);
+           const des::Model* _parent, u32 _id, Network* _network,
+           des::EventHandler _recvHandler)
+    : des::Model(_sim, _name, _parent), id(_id), network_(_network),
+      phaseStats_(nullptr), trace_(nullptr), bandwidth_(nullptr),
+      nodeClass_(Bandwidth::SENDER), recvHandler_(_recvHandler) {
+  // the generator is seeded once by seed(), seeding it here as well would
+  //  double the cost of bulk construction
 
   // register with the network
   network_->registerNode(id, this);
@@ -55,21 +127,42 @@ Node::Node(des::Simulator* _sim, const std::string& _name,
 Node::~Node() {}
 
 void Node::future_recv(Message* _msg, des::Time _time) {
-  simulator->addEvent(new MessageEvent(
-      this, static_cast<des::EventHandler>(&Node::handle_recv), _time, _msg));
+  simulator->addEvent(new MessageEvent(this, recvHandler_, _time, _msg));
 }
 
-void Node::send(Message* _msg) {
-  // create and add the send message event
-  simulator->addEvent(new MessageEvent(
-      this, static_cast<des::EventHandler>(&Node::handle_enqueue),
-      simulator->time().plusEps(), _msg));
+void Node::seed(u64 _seed) {
+  // splitmix64 of a per-node counter gives well separated streams
+  u64 z = _seed + ((u64)id + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z = z ^ (z >> 31);
+  prng.seed(z);
 }
 
-void Node::send(Message* _msg, des::Time _time) {
-  simulator->addEvent(new MessageEvent(
-      this, static_cast<des::EventHandler>(&Node::handle_enqueue),
-      _time, _msg));
+void Node::setPhaseStats(PhaseStats* _phaseStats) {
+  phaseStats_ = _phaseStats;
+}
+
+void Node::setTrace(TraceWriter* _trace) {
+  trace_ = _trace;
+}
+
+void Node::setBandwidth(Bandwidth* _bandwidth,
+                        Bandwidth::NodeClass _nodeClass) {
+  bandwidth_ = _bandwidth;
+  nodeClass_ = _nodeClass;
+}
+
+u64 Node::queued() const {
+  return 0;
+}
+
+void Node::handle_timer(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(Node), "handle_timer");
+  ProfileProbe probe(SITE);
+  TimerEvent* evt = reinterpret_cast<TimerEvent*>(_event);
+  evt->timer->expire(evt->generation);
+  delete evt;
 }
 
 u64 Node::cyclesToSend(u32 _size, f64 _rate) {
@@ -87,65 +180,3 @@ u64 Node::cyclesToSend(u32 _size, f64 _rate) {
   }
   return (u64)cycles;
 }
-
-void Node::handle_recv(des::Event* _event) {
-  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
-  dlogf("%s", evt->msg->toString().c_str());
-  this->recv(evt->msg);
-  delete evt;
-}
-
-void Node::handle_enqueue(des::Event* _event) {
-  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
-  if (queuing_ == "fifo") {
-    fifoQueue_.push(evt->msg);
-  } else if (queuing_ == "priority") {
-    priorityQueue_.push(evt->msg);
-  } else {
-    assert(false);
-  }
-  delete evt;
-
-  if (!eventPending_) {
-    handle_send(nullptr);
-  }
-}
-
-void Node::handle_send(des::Event* _event) {
-  if (_event) {  // might be null due to direct call
-    assert(eventPending_);
-    delete _event;
-  } else {
-    assert(!eventPending_);
-  }
-
-  Message* msg = nullptr;
-  bool more = false;
-  if (queuing_ == "fifo") {
-    msg = fifoQueue_.front();
-    fifoQueue_.pop();
-    more = !fifoQueue_.empty();
-  } else if (queuing_ == "priority") {
-    msg = priorityQueue_.top();
-    priorityQueue_.pop();
-    more = !priorityQueue_.empty();
-  } else {
-    assert(false);
-  }
-
-  Node* node = network_->getNode(msg->dst);
-  des::Time now = simulator->time();
-  des::Time recvTime(now + msg->size + network_->delay());
-  node->future_recv(msg, recvTime);
-  dlogf("%s", msg->toString().c_str());
-
-  if (more) {
-    des::Time nextTime(now + msg->size);
-    simulator->addEvent(new des::Event(
-      this, static_cast<des::EventHandler>(&Node::handle_send),
-      nextTime));
-    eventPending_ = true;
-  } else {
-    eventPending_ = false;
-  }
-}
@@ -35,19 +35,92 @@
 #include <prim/prim.h>
 #include <rnd/Random.h>
 
-#include <queue>
 #include <string>
-#include <vector>
 
+#include "ratecontrol/Bandwidth.h"
 #include "ratecontrol/Message.h"
+#include "ratecontrol/Pool.h"
+#include "ratecontrol/SmallRandom.h"
 
 class Network;
+class Node;
+class PhaseStats;
+class TraceWriter;
 
+/*
+ * This is the random number generator of a node. Building with COMPACT_NODES
+ *  replaces the rnd::Random state with a 32 byte generator.
+ */
+#ifdef COMPACT_NODES
+typedef SmallRandom NodeRandom;
+#else
+typedef rnd::Random NodeRandom;
+#endif
+
+/*
+ * This is a plain event allocated from a pool. Nodes use it for their
+ *  recurring events so the steady state doesn't touch the heap.
+ */
+class NodeEvent : public des::Event, public Pooled<NodeEvent> {
+ public:
+  NodeEvent(des::Model* _model, des::EventHandler _handler, des::Time _time);
+  ~NodeEvent();
+};
+
+/*
+ * This is a wake-up for a node that can be set, moved and cancelled in O(1).
+ *  A timer has at most one live event in the simulator. Moving the wake-up
+ *  later or cancelling it keeps the live event, which is absorbed (or
+ *  re-armed) when it fires. Only moving it earlier schedules a new event, the
+ *  old one becomes stale and is discarded without calling the handler.
+ */
+class Timer {
+ public:
+  typedef void (Node::*Handler)();
+
+  Timer(Node* _node, Handler _handler);
+  ~Timer();
+
+  void set(des::Time _time);
+  void cancel();
+  bool armed() const;
+  des::Time time() const;
+
+ private:
+  friend class Node;
+
+  void expire(u64 _generation);
+
+  Node* node_;
+  const Handler handler_;
+  bool armed_;
+  des::Time target_;
+  bool live_;  // the event of the current generation is pending
+  des::Time liveTime_;
+  u64 generation_;
+};
+
+/*
+ * This is the event of a timer, tagged with the generation it was created
+ *  for.
+ */
+class TimerEvent : public des::Event, public Pooled<TimerEvent> {
+ public:
+  TimerEvent(des::Model* _model, des::EventHandler _handler, des::Time _time,
+             Timer* _timer, u64 _generation);
+  ~TimerEvent();
+
+  Timer* timer;
+  u64 generation;
+};
+
+/*
+ * This is the type independent part of every node in the network. The send
+ *  and receive pipeline is implemented by QueuedNode which is specialized at
+ *  compile time for the concrete node type and queuing discipline.
+ */
 class Node : public des::Model {
  public:
-  Node(des::Simulator* _sim, const std::string& _name,
-       const des::Model* _parent, u32 _id, const std::string& _queuing,
-       Network* _network);
   virtual ~Node();
 
   /*
@@ -56,23 +129,46 @@ class Node : public des::Model {
   void future_recv(Message* _msg, des::Time _time);
 
   /*
-   * When a message is received at this node, this method will be called.
+   * This seeds the node's random number generator with a stream derived from
+   *  the global seed and the node id. The result doesn't depend on the order
+   *  of node creation or the number of threads. Every node must be seeded
+   *  before the simulation starts.
    */
-  virtual void recv(Message* _msg) = 0;
+  void seed(u64 _seed);
 
-  const u32 id;
+  /*
+   * This enables recording of statistics during the simulation.
+   */
+  void setPhaseStats(PhaseStats* _phaseStats);
 
- protected:
   /*
-   * This sends a message from this node at the next available time.
+   * This enables writing of a binary trace of all message events.
    */
-  void send(Message* _msg);
+  void setTrace(TraceWriter* _trace);
 
   /*
-   * This sends a message from this node at the next available time after
-   * the time specified.
+   * This enables accumulation of bandwidth for the class this node is in.
    */
-  void send(Message* _msg, des::Time _time);
+  void setBandwidth(Bandwidth* _bandwidth, Bandwidth::NodeClass _nodeClass);
+
+  /*
+   * This returns the number of messages waiting in the queues of this node.
+   *  It is only used for progress reporting and may be read from another
+   *  thread while the simulation runs, thus it is approximate.
+   */
+  virtual u64 queued() const;
+
+  const u32 id;
+
+ protected:
+  friend class Timer;
+
+  /*
+   * '_recvHandler' is the handler for the events created by future_recv().
+   */
+  Node(des::Simulator* _sim, const std::string& _name,
+       const des::Model* _parent, u32 _id, Network* _network,
+       des::EventHandler _recvHandler);
 
   /*
    * This computes how many cycles would be needed to send a message at a given
@@ -80,21 +176,17 @@ class Node : public des::Model {
    */
   u64 cyclesToSend(u32 _size, f64 _rate);
 
-  rnd::Random prng;
+  NodeRandom prng;
+  Network* network_;
+  PhaseStats* phaseStats_;
+  TraceWriter* trace_;
+  Bandwidth* bandwidth_;
+  Bandwidth::NodeClass nodeClass_;
 
  private:
-  void handle_recv(des::Event* _event);
-  void handle_enqueue(des::Event* _event);
-  void handle_send(des::Event* _event);
-
+  void handle_timer(des::Event* _event);
 
-  bool eventPending_;
-  const std::string queuing_;
-  std::queue<Message*> fifoQueue_;
-  std::priority_queue<Message*, std::vector<Message*>,
-                      MessagePriorityComparator> priorityQueue_;
-
-  Network* network_;
+  const des::EventHandler recvHandler_;
 };
 
 #endif  // RATECONTROL_NODE_H_
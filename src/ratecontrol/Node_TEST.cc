@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <cassert>
+
+#include <vector>
+
+#include "ratecontrol/Network.h"
+#include "ratecontrol/Node.h"
+#include "ratecontrol/Pool.h"
+
+namespace {
+
+/*
+ * This node drives a timer with a script of actions, each executed by its own
+ *  event, and records the ticks the timer fired at.
+ */
+class TimerNode : public Node {
+ public:
+  struct Action {
+    des::Tick tick;
+    bool cancel;
+    des::Tick target;  // for set
+  };
+
+  TimerNode(des::Simulator* _sim, Network* _network,
+            const std::vector<Action>& _actions, des::Tick _period)
+      : Node(_sim, "TimerNode", nullptr, 0, _network,
+             static_cast<des::EventHandler>(&TimerNode::handle_recv)),
+        actions_(_actions), period_(_period),
+        timer_(this, static_cast<Timer::Handler>(&TimerNode::expired)) {
+    for (u32 idx = 0; idx < actions_.size(); idx++) {
+      simulator->addEvent(new des::ItemEvent<u32>(
+          this, static_cast<des::EventHandler>(&TimerNode::handle_action),
+          des::Time(actions_[idx].tick), idx));
+    }
+  }
+
+  std::vector<des::Tick> fired;
+
+ private:
+  void handle_recv(des::Event* _event) {
+    (void)_event;  // unused
+    assert(false);
+  }
+
+  void handle_action(des::Event* _event) {
+    des::ItemEvent<u32>* evt = reinterpret_cast<des::ItemEvent<u32>*>(_event);
+    const Action& action = actions_.at(evt->item);
+    delete evt;
+    if (action.cancel) {
+      timer_.cancel();
+    } else {
+      timer_.set(des::Time(action.target));
+    }
+  }
+
+  void expired() {
+    ASSERT_FALSE(timer_.armed());
+    fired.push_back(simulator->time().tick);
+    if (period_ > 0 && fired.size() < 3) {
+      timer_.set(des::Time(simulator->time().tick + period_));
+    }
+  }
+
+  const std::vector<Action> actions_;
+  const des::Tick period_;
+  Timer timer_;
+};
+
+// this also returns the number of timer events that were created
+std::vector<des::Tick> run(const std::vector<TimerNode::Action>& _actions,
+                           u64* _events = nullptr, des::Tick _period = 0) {
+  u64 allocs = Pool<TimerEvent>::stats().allocs;
+  des::Simulator sim(1);
+  Network network(&sim, "Network", nullptr, 1);
+  network.reserve(1);
+  TimerNode node(&sim, &network, _actions, _period);
+  sim.simulate(false);
+  if (_events != nullptr) {
+    *_events = Pool<TimerEvent>::stats().allocs - allocs;
+  }
+  return node.fired;
+}
+
+const bool SET = false;
+const bool CANCEL = true;
+
+}  // namespace
+
+TEST(Timer, fires) {
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 100}}, &events), std::vector<des::Tick>({100}));
+  ASSERT_EQ(events, 1u);
+}
+
+TEST(Timer, cancel) {
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 100}, {50, CANCEL, 0}}, &events),
+            std::vector<des::Tick>());
+  ASSERT_EQ(events, 1u);
+}
+
+TEST(Timer, moveLater) {
+  // the live event at 100 is absorbed and re-armed for 300
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 100}, {10, SET, 300}}, &events),
+            std::vector<des::Tick>({300}));
+  ASSERT_EQ(events, 2u);
+}
+
+TEST(Timer, moveEarlier) {
+  // the event at 300 becomes stale and must not fire again
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 300}, {10, SET, 100}}, &events),
+            std::vector<des::Tick>({100}));
+  ASSERT_EQ(events, 2u);
+}
+
+TEST(Timer, cancelThenSetLater) {
+  // the live event of the cancelled wake-up is reused for the later one
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 100}, {50, CANCEL, 0}, {60, SET, 200}}, &events),
+            std::vector<des::Tick>({200}));
+  ASSERT_EQ(events, 2u);
+}
+
+TEST(Timer, cancelThenSetEarlier) {
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 300}, {50, CANCEL, 0}, {60, SET, 100}}, &events),
+            std::vector<des::Tick>({100}));
+  ASSERT_EQ(events, 2u);
+}
+
+TEST(Timer, staleEventBeforeTarget) {
+  // the stale event at 300 fires while the timer is set for 350 and must be
+  //  discarded, it must neither fire nor re-arm the timer
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 300}, {10, SET, 100}, {150, SET, 350}}, &events),
+            std::vector<des::Tick>({100, 350}));
+  ASSERT_EQ(events, 3u);
+}
+
+TEST(Timer, rearmFromHandler) {
+  u64 events;
+  ASSERT_EQ(run({{1, SET, 10}}, &events, 25),
+            std::vector<des::Tick>({10, 35, 60}));
+  ASSERT_EQ(events, 3u);
+}
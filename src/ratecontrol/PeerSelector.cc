@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/PeerSelector.h"
+
+#include <cassert>
+
+#include <algorithm>
+
+PeerSelector::~PeerSelector() {}
+
+PeerSelector* PeerSelector::create(const std::string& _strategy, u32 _self,
+                                   u32 _minId, u32 _maxId,
+                                   NodeRandom* _prng) {
+  if (_strategy == "random") {
+    return new RandomPeerSelector(_self, _minId, _maxId, _prng);
+  } else if (_strategy == "ring") {
+    return new RingPeerSelector(_self, _minId, _maxId, _prng);
+  } else if (_strategy == "generous") {
+    return new GenerousPeerSelector(_self, _minId, _maxId, _prng);
+  } else {
+    return nullptr;
+  }
+}
+
+bool PeerSelector::valid(const std::string& _strategy) {
+  return _strategy == "random" || _strategy == "ring" ||
+      _strategy == "generous";
+}
+
+void PeerSelector::feedback(u32 _peer, bool _gave) {
+  (void)_peer;  // unused
+  (void)_gave;  // unused
+}
+
+u32 PeerSelector::numPeers() const {
+  return maxId_ - minId_;
+}
+
+PeerSelector::PeerSelector(u32 _self, u32 _minId, u32 _maxId,
+                           NodeRandom* _prng)
+    : self_(_self), minId_(_minId), maxId_(_maxId), prng_(_prng) {
+  assert(minId_ <= self_ && self_ <= maxId_);
+}
+
+u32 PeerSelector::peer(u32 _index) const {
+  assert(_index < numPeers());
+  u32 id = minId_ + _index;
+  return id < self_ ? id : id + 1;
+}
+
+void PeerSelector::sample(u32 _count, std::vector<u32>* _peers) {
+  // Floyd's algorithm draws exactly '_count' random numbers
+  u32 n = numPeers();
+  assert(_count <= n);
+  u64 first = _peers->size();
+  for (u32 j = n - _count; j < n; j++) {
+    u32 t = peer(prng_->nextU64(0, j));
+    if (std::find(_peers->begin() + first, _peers->end(), t) !=
+        _peers->end()) {
+      t = peer(j);
+    }
+    _peers->push_back(t);
+  }
+}
+
+RandomPeerSelector::RandomPeerSelector(u32 _self, u32 _minId, u32 _maxId,
+                                       NodeRandom* _prng)
+    : PeerSelector(_self, _minId, _maxId, _prng) {}
+
+RandomPeerSelector::~RandomPeerSelector() {}
+
+void RandomPeerSelector::select(u32 _count, std::vector<u32>* _peers) {
+  sample(_count, _peers);
+}
+
+RingPeerSelector::RingPeerSelector(u32 _self, u32 _minId, u32 _maxId,
+                                   NodeRandom* _prng)
+    : PeerSelector(_self, _minId, _maxId, _prng),
+      next_(_self - _minId) {}  // index of the successor
+
+RingPeerSelector::~RingPeerSelector() {}
+
+void RingPeerSelector::select(u32 _count, std::vector<u32>* _peers) {
+  u32 n = numPeers();
+  assert(_count <= n);
+  for (u32 c = 0; c < _count; c++) {
+    if (next_ >= n) {
+      next_ = 0;
+    }
+    _peers->push_back(peer(next_++));
+  }
+}
+
+GenerousPeerSelector::GenerousPeerSelector(u32 _self, u32 _minId,
+                                           u32 _maxId, NodeRandom* _prng)
+    : PeerSelector(_self, _minId, _maxId, _prng) {
+  generous_.reserve(CAPACITY);
+}
+
+GenerousPeerSelector::~GenerousPeerSelector() {}
+
+void GenerousPeerSelector::select(u32 _count, std::vector<u32>* _peers) {
+  assert(_count <= numPeers());
+  u64 first = _peers->size();
+
+  // take the most recently generous peers first
+  u32 known = std::min((u32)generous_.size(), _count);
+  _peers->insert(_peers->end(), generous_.begin(),
+                 generous_.begin() + known);
+
+  // fill with random peers, the sample has enough distinct peers to cover
+  //  any overlap with the generous ones
+  if (known < _count) {
+    scratch_.clear();
+    sample(_count, &scratch_);
+    for (u32 p : scratch_) {
+      if (_peers->size() - first == _count) {
+        break;
+      }
+      if (std::find(_peers->begin() + first, _peers->end(), p) ==
+          _peers->end()) {
+        _peers->push_back(p);
+      }
+    }
+  }
+  assert(_peers->size() - first == _count);
+}
+
+void GenerousPeerSelector::feedback(u32 _peer, bool _gave) {
+  std::vector<u32>::iterator it =
+      std::find(generous_.begin(), generous_.end(), _peer);
+  if (it != generous_.end()) {
+    generous_.erase(it);
+  }
+  if (_gave) {
+    if (generous_.size() == CAPACITY) {
+      generous_.pop_back();
+    }
+    generous_.insert(generous_.begin(), _peer);
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PEERSELECTOR_H_
+#define RATECONTROL_PEERSELECTOR_H_
+
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+#include "ratecontrol/Node.h"
+
+/*
+ * This chooses which peers a node sends requests to. The peers are the ids
+ *  in [minId, maxId] except the node itself. Every strategy selects k
+ *  distinct peers in O(k) time and memory, independent of the number of
+ *  peers.
+ */
+class PeerSelector {
+ public:
+  virtual ~PeerSelector();
+
+  /*
+   * This creates the selector named by '_strategy' ("random", "ring", or
+   *  "generous"). nullptr is returned for an unknown strategy.
+   */
+  static PeerSelector* create(const std::string& _strategy, u32 _self,
+                              u32 _minId, u32 _maxId, NodeRandom* _prng);
+
+  /*
+   * This returns true if '_strategy' names a selector known to create().
+   */
+  static bool valid(const std::string& _strategy);
+
+  /*
+   * This appends '_count' distinct peers to '_peers'.
+   */
+  virtual void select(u32 _count, std::vector<u32>* _peers) = 0;
+
+  /*
+   * This informs the selector whether a peer gave anything when asked.
+   */
+  virtual void feedback(u32 _peer, bool _gave);
+
+  u32 numPeers() const;
+
+ protected:
+  PeerSelector(u32 _self, u32 _minId, u32 _maxId, NodeRandom* _prng);
+
+  // this maps [0, numPeers) onto the peer ids
+  u32 peer(u32 _index) const;
+
+  // this appends '_count' distinct random peers (Floyd's algorithm)
+  void sample(u32 _count, std::vector<u32>* _peers);
+
+  const u32 self_;
+  const u32 minId_;
+  const u32 maxId_;
+  NodeRandom* prng_;
+};
+
+/*
+ * This selects peers uniformly at random.
+ */
+class RandomPeerSelector : public PeerSelector {
+ public:
+  RandomPeerSelector(u32 _self, u32 _minId, u32 _maxId, NodeRandom* _prng);
+  ~RandomPeerSelector();
+
+  void select(u32 _count, std::vector<u32>* _peers) override;
+};
+
+/*
+ * This walks the ring of peers starting at the node's successor, each
+ *  selection continues where the previous one stopped.
+ */
+class RingPeerSelector : public PeerSelector {
+ public:
+  RingPeerSelector(u32 _self, u32 _minId, u32 _maxId, NodeRandom* _prng);
+  ~RingPeerSelector();
+
+  void select(u32 _count, std::vector<u32>* _peers) override;
+
+ private:
+  u32 next_;  // index of the next peer
+};
+
+/*
+ * This prefers the peers that most recently gave something, the remaining
+ *  peers are selected at random. At most CAPACITY peers are remembered.
+ */
+class GenerousPeerSelector : public PeerSelector {
+ public:
+  GenerousPeerSelector(u32 _self, u32 _minId, u32 _maxId,
+                       NodeRandom* _prng);
+  ~GenerousPeerSelector();
+
+  void select(u32 _count, std::vector<u32>* _peers) override;
+  void feedback(u32 _peer, bool _gave) override;
+
+  static const u32 CAPACITY = 16;
+
+ private:
+  std::vector<u32> generous_;  // most recent first
+  std::vector<u32> scratch_;
+};
+
+#endif  // RATECONTROL_PEERSELECTOR_H_
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <prim/prim.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ratecontrol/Node.h"
+#include "ratecontrol/PeerSelector.h"
+
+namespace {
+
+const char* STRATEGIES[] = {"random", "ring", "generous"};
+
+// this checks that the peers appended after '_first' are '_count' distinct
+//  ids in [_minId, _maxId] other than '_self'
+void checkPeers(const std::vector<u32>& _peers, u64 _first, u32 _count,
+                u32 _self, u32 _minId, u32 _maxId) {
+  ASSERT_EQ(_peers.size() - _first, _count);
+  std::set<u32> unique(_peers.begin() + _first, _peers.end());
+  ASSERT_EQ(unique.size(), _count);
+  for (u32 peer : unique) {
+    ASSERT_GE(peer, _minId);
+    ASSERT_LE(peer, _maxId);
+    ASSERT_NE(peer, _self);
+  }
+}
+
+}  // namespace
+
+TEST(PeerSelector, create) {
+  NodeRandom prng;
+  prng.seed(1);
+  for (const char* strategy : STRATEGIES) {
+    ASSERT_TRUE(PeerSelector::valid(strategy));
+    PeerSelector* selector = PeerSelector::create(strategy, 5, 3, 9, &prng);
+    ASSERT_NE(selector, nullptr);
+    ASSERT_EQ(selector->numPeers(), 6u);
+    delete selector;
+  }
+  ASSERT_FALSE(PeerSelector::valid("bogus"));
+  ASSERT_EQ(PeerSelector::create("bogus", 5, 3, 9, &prng), nullptr);
+}
+
+TEST(PeerSelector, distinct) {
+  // every strategy, with the node at either end and in the middle of the
+  //  range, for every count up to all peers
+  NodeRandom prng;
+  prng.seed(12345);
+  const u32 MIN_ID = 10;
+  const u32 MAX_ID = 30;
+  for (const char* strategy : STRATEGIES) {
+    for (u32 self : {MIN_ID, 17u, MAX_ID}) {
+      PeerSelector* selector =
+          PeerSelector::create(strategy, self, MIN_ID, MAX_ID, &prng);
+      for (u32 count = 0; count <= selector->numPeers(); count++) {
+        for (u32 trial = 0; trial < 10; trial++) {
+          // the selection is appended to what the vector already holds
+          std::vector<u32> peers = {self};
+          selector->select(count, &peers);
+          ASSERT_EQ(peers.front(), self);
+          checkPeers(peers, 1, count, self, MIN_ID, MAX_ID);
+          if (!peers.empty()) {
+            selector->feedback(peers.back(), trial % 2 == 0);
+          }
+        }
+      }
+      delete selector;
+    }
+  }
+}
+
+TEST(PeerSelector, randomCoverage) {
+  // every peer is selected about equally often
+  NodeRandom prng;
+  prng.seed(999);
+  RandomPeerSelector selector(4, 0, 10, &prng);
+  std::vector<u32> hits(11, 0);
+  const u32 TRIALS = 20000;
+  for (u32 trial = 0; trial < TRIALS; trial++) {
+    std::vector<u32> peers;
+    selector.select(3, &peers);
+    for (u32 peer : peers) {
+      hits[peer]++;
+    }
+  }
+  ASSERT_EQ(hits[4], 0u);
+  f64 expected = TRIALS * 3.0 / 10;
+  for (u32 id = 0; id <= 10; id++) {
+    if (id != 4) {
+      ASSERT_NEAR(hits[id], expected, expected * 0.05) << id;
+    }
+  }
+}
+
+TEST(PeerSelector, ring) {
+  // the walk starts at the successor, skips the node and wraps around
+  NodeRandom prng;
+  prng.seed(1);
+  RingPeerSelector selector(12, 10, 14, &prng);
+  std::vector<u32> peers;
+  selector.select(3, &peers);
+  ASSERT_EQ(peers, std::vector<u32>({13, 14, 10}));
+  peers.clear();
+  selector.select(4, &peers);
+  ASSERT_EQ(peers, std::vector<u32>({11, 13, 14, 10}));
+}
+
+TEST(PeerSelector, generous) {
+  NodeRandom prng;
+  prng.seed(1);
+  GenerousPeerSelector selector(0, 0, 100, &prng);
+
+  // the most recently generous peers come first
+  selector.feedback(7, true);
+  selector.feedback(9, true);
+  selector.feedback(3, true);
+  selector.feedback(9, false);  // forgotten
+  std::vector<u32> peers;
+  selector.select(4, &peers);
+  ASSERT_EQ(peers[0], 3u);
+  ASSERT_EQ(peers[1], 7u);
+  checkPeers(peers, 0, 4, 0, 0, 100);
+
+  // at most CAPACITY peers are remembered, the oldest is dropped
+  for (u32 peer = 1; peer <= GenerousPeerSelector::CAPACITY + 1; peer++) {
+    selector.feedback(peer, true);
+  }
+  peers.clear();
+  selector.select(GenerousPeerSelector::CAPACITY, &peers);
+  for (u32 idx = 0; idx < GenerousPeerSelector::CAPACITY; idx++) {
+    ASSERT_EQ(peers[idx], GenerousPeerSelector::CAPACITY + 1 - idx);
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PERTHREAD_H_
+#define RATECONTROL_PERTHREAD_H_
+
+#include <prim/prim.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * This owns one instance of T per thread using it. get() returns the calling
+ *  thread's instance, created by '_create' on first use, without locking in
+ *  the common case: each thread caches the instance of the PerThread<T> it
+ *  used last. A thread alternating between several PerThread<T> objects
+ *  finds its instances again with a locked lookup, it never creates another.
+ */
+template <typename T>
+class PerThread {
+ public:
+  explicit PerThread(std::function<T*()> _create);
+  ~PerThread();
+
+  T* get();
+
+  /*
+   * This returns the instances of all threads. The caller must not modify
+   *  them while other threads might use them.
+   */
+  std::vector<T*> all() const;
+
+ private:
+  struct Cache {
+    u64 owner;
+    T* instance;
+  };
+
+  T* find();
+
+  const u64 id_;  // unique per object, identifies the thread's cached instance
+  const std::function<T*()> create_;
+  mutable std::mutex lock_;
+  std::unordered_map<std::thread::id, T*> instances_;
+  std::vector<T*> ordered_;  // in order of creation
+
+  static std::atomic<u64> nextId_;
+  static thread_local Cache cache_;
+};
+
+#include "ratecontrol/PerThread.tcc"
+
+#endif  // RATECONTROL_PERTHREAD_H_
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PERTHREAD_H_
+#error "do not include this file, include PerThread.h instead"
+#endif  // RATECONTROL_PERTHREAD_H_
+
+template <typename T>
+std::atomic<u64> PerThread<T>::nextId_(1);
+
+template <typename T>
+thread_local typename PerThread<T>::Cache PerThread<T>::cache_ = {0, nullptr};
+
+template <typename T>
+PerThread<T>::PerThread(std::function<T*()> _create)
+    : id_(nextId_.fetch_add(1)), create_(_create) {}
+
+template <typename T>
+PerThread<T>::~PerThread() {
+  for (T* instance : ordered_) {
+    delete instance;
+  }
+}
+
+template <typename T>
+T* PerThread<T>::get() {
+  if (cache_.owner != id_) {
+    cache_.instance = find();
+    cache_.owner = id_;
+  }
+  return cache_.instance;
+}
+
+template <typename T>
+std::vector<T*> PerThread<T>::all() const {
+  std::lock_guard<std::mutex> guard(lock_);
+  return ordered_;
+}
+
+template <typename T>
+T* PerThread<T>::find() {
+  std::thread::id thread = std::this_thread::get_id();
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    typename std::unordered_map<std::thread::id, T*>::const_iterator it =
+        instances_.find(thread);
+    if (it != instances_.end()) {
+      return it->second;
+    }
+  }
+  T* instance = create_();
+  std::lock_guard<std::mutex> guard(lock_);
+  instances_[thread] = instance;
+  ordered_.push_back(instance);
+  return instance;
+}
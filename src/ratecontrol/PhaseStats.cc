@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/PhaseStats.h"
+
+#include <cassert>
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+PhaseStats::PhaseStats(const std::vector<des::Tick>& _schedule)
+    : lastTick_(std::numeric_limits<des::Tick>::max()),
+      shards_([this] { return createShard(); }) {
+  std::vector<des::Tick> ticks(_schedule);
+  std::sort(ticks.begin(), ticks.end());
+  for (u64 idx = 1; idx + 1 < ticks.size(); idx++) {
+    sections_.push_back({ticks.at(idx), ticks.at(idx + 1)});
+  }
+}
+
+PhaseStats::~PhaseStats() {}
+
+void PhaseStats::recordLatency(des::Tick _end, u64 _latency) {
+  Shard* s = shards_.get();
+  for (u32 sect = 0; sect < sections_.size(); sect++) {
+    if (_end >= sections_[sect].start && _end <= sections_[sect].stop) {
+      s->latencies[sect].add(_latency);
+    }
+  }
+}
+
+void PhaseStats::recordOverhead(des::Tick _end, u32 _size) {
+  assert(_size > 0);
+  Shard* s = shards_.get();
+  des::Tick first = _end + 1 >= _size ? _end + 1 - _size : 0;
+  for (u32 sect = 0; sect < sections_.size(); sect++) {
+    des::Tick lo = std::max(first, sections_[sect].start);
+    des::Tick hi = std::min(_end, sections_[sect].stop);
+    if (lo <= hi) {
+      s->overheads[sect] += hi - lo + 1;
+    }
+  }
+}
+
+void PhaseStats::setLastTick(des::Tick _tick) {
+  lastTick_ = _tick;
+}
+
+des::Tick PhaseStats::lastStop() const {
+  des::Tick stop = 0;
+  for (const Section& section : sections_) {
+    stop = std::max(stop, section.stop);
+  }
+  return stop;
+}
+
+std::string PhaseStats::toString() const {
+  std::vector<Shard*> shards = shards_.all();
+  std::stringstream ss;
+  ss << std::setprecision(10);
+  for (u32 sect = 0; sect < sections_.size(); sect++) {
+    // merge all shards
+    Histogram latencies;
+    u64 overhead = 0;
+    for (const Shard* shard : shards) {
+      latencies.merge(shard->latencies[sect]);
+      overhead += shard->overheads[sect];
+    }
+    des::Tick stop = std::min(sections_[sect].stop, lastTick_);
+    des::Tick ticks = stop >= sections_[sect].start ?
+        stop - sections_[sect].start + 1 : 0;
+
+    ss << "Section #" << (sect + 1) << '\n';
+    ss << "bandwidth overhead = ";
+    if (ticks > 0) {
+      ss << ((f64)overhead / ticks);
+    } else {
+      ss << "nan";
+    }
+    ss << '\n';
+    const f64 percentiles[] = {0.99, 0.999, 0.9999, 0.99999};
+    const char* names[] = {"99%ile", "99.9%ile", "99.99%ile", "99.999%ile"};
+    for (u32 p = 0; p < 4; p++) {
+      ss << names[p] << " latency = ";
+      if (latencies.count() > 0) {
+        ss << latencies.percentile(percentiles[p]);
+      } else {
+        ss << "nan";
+      }
+      ss << '\n';
+    }
+    ss << '\n';
+  }
+  return ss.str();
+}
+
+PhaseStats::Shard* PhaseStats::createShard() const {
+  Shard* s = new Shard();
+  s->latencies.resize(sections_.size());
+  s->overheads.resize(sections_.size(), 0);
+  return s;
+}
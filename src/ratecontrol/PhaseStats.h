@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PHASESTATS_H_
+#define RATECONTROL_PHASESTATS_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+#include "ratecontrol/Histogram.h"
+#include "ratecontrol/PerThread.h"
+
+/*
+ * This collects end-to-end latency and bandwidth overhead statistics during
+ *  the simulation for each traffic section. The sections are derived from the
+ *  tick schedule of the sender control: section N spans from the Nth to the
+ *  (N+1)th scheduled tick, both inclusive. The first scheduled phase is
+ *  considered warm-up and isn't reported.
+ *
+ * Samples are recorded into per-thread shards without locking and merged
+ *  when the statistics are reported.
+ */
+class PhaseStats {
+ public:
+  explicit PhaseStats(const std::vector<des::Tick>& _schedule);
+  ~PhaseStats();
+
+  /*
+   * This records the total latency of a transaction which ended at '_end'.
+   */
+  void recordLatency(des::Tick _end, u64 _latency);
+
+  /*
+   * This records the phits of an overhead (non-plain) message received at
+   *  '_end'. The phits are spread over the '_size' ticks ending at '_end'.
+   */
+  void recordOverhead(des::Tick _end, u32 _size);
+
+  /*
+   * This sets the last simulated tick. Sections extending past it are
+   *  averaged over their simulated part only, as parser/parser.py does.
+   */
+  void setLastTick(des::Tick _tick);
+
+  /*
+   * This returns the last tick of the last section, samples ending later
+   *  aren't recorded.
+   */
+  des::Tick lastStop() const;
+
+  /*
+   * This formats the statistics the same way as parser/parser.py.
+   */
+  std::string toString() const;
+
+ private:
+  struct Section {
+    des::Tick start;
+    des::Tick stop;
+  };
+
+  struct Shard {
+    std::vector<Histogram> latencies;
+    std::vector<u64> overheads;
+  };
+
+  Shard* createShard() const;
+
+  std::vector<Section> sections_;
+  des::Tick lastTick_;
+  PerThread<Shard> shards_;
+};
+
+#endif  // RATECONTROL_PHASESTATS_H_
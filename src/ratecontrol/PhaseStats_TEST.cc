@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <prim/prim.h>
+
+#include <cstdlib>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ratecontrol/PhaseStats.h"
+
+namespace {
+
+// this returns the value of '_name' in section '_section' of the report
+std::string value(const std::string& _report, u32 _section,
+                  const std::string& _name) {
+  std::stringstream ss(_report);
+  std::string line;
+  std::string header = "Section #" + std::to_string(_section);
+  bool inside = false;
+  while (std::getline(ss, line)) {
+    if (line.compare(0, 9, "Section #") == 0) {
+      inside = line == header;
+    } else if (inside && line.compare(0, _name.size() + 3,
+                                      _name + " = ") == 0) {
+      return line.substr(_name.size() + 3);
+    }
+  }
+  return "";
+}
+
+f64 number(const std::string& _report, u32 _section,
+           const std::string& _name) {
+  return strtod(value(_report, _section, _name).c_str(), nullptr);
+}
+
+}  // namespace
+
+TEST(PhaseStats, sections) {
+  // the first phase [0, 100] is warm-up, the sections are [100, 200] and
+  //  [200, 300]
+  PhaseStats stats({200, 0, 300, 100});
+  std::string report = stats.toString();
+  ASSERT_NE(value(report, 1, "99%ile latency"), "");
+  ASSERT_NE(value(report, 2, "99%ile latency"), "");
+  ASSERT_EQ(value(report, 3, "99%ile latency"), "");
+}
+
+TEST(PhaseStats, latencyBoundaries) {
+  PhaseStats stats({0, 100, 200, 300});
+  stats.recordLatency(99, 1000);   // warm-up
+  stats.recordLatency(100, 5);     // section 1
+  stats.recordLatency(200, 50);    // sections 1 and 2
+  stats.recordLatency(300, 60);    // section 2
+  stats.recordLatency(301, 2000);  // after the last section
+  std::string report = stats.toString();
+
+  // the 99th percentile of two samples is the larger one
+  ASSERT_EQ(value(report, 1, "99%ile latency"), "50");
+  ASSERT_EQ(value(report, 2, "99%ile latency"), "60");
+}
+
+TEST(PhaseStats, emptySection) {
+  PhaseStats stats({0, 100, 200, 300});
+  stats.recordLatency(150, 5);
+  std::string report = stats.toString();
+  ASSERT_EQ(value(report, 1, "99%ile latency"), "5");
+  ASSERT_EQ(value(report, 2, "99%ile latency"), "nan");
+  ASSERT_EQ(number(report, 2, "bandwidth overhead"), 0.0);
+}
+
+TEST(PhaseStats, overheadBoundaries) {
+  PhaseStats stats({0, 100, 200, 300});
+  stats.recordOverhead(99, 1);   // warm-up
+  stats.recordOverhead(100, 1);  // section 1
+  stats.recordOverhead(200, 1);  // sections 1 and 2
+  stats.recordOverhead(300, 1);  // section 2
+  stats.recordOverhead(301, 1);  // after the last section
+  stats.recordOverhead(105, 10);  // [96, 105], 6 phits in section 1
+  std::string report = stats.toString();
+
+  // both ends are inclusive, thus each section spans 101 ticks. the report
+  //  has 10 significant digits
+  ASSERT_NEAR(number(report, 1, "bandwidth overhead"), 8.0 / 101, 1e-10);
+  ASSERT_NEAR(number(report, 2, "bandwidth overhead"), 2.0 / 101, 1e-10);
+}
+
+TEST(PhaseStats, lastTick) {
+  PhaseStats stats({0, 100, 200, 300});
+  stats.recordOverhead(250, 51);  // [200, 250]
+  stats.setLastTick(250);
+  std::string report = stats.toString();
+
+  // a partially simulated section is averaged over its simulated ticks only
+  ASSERT_DOUBLE_EQ(number(report, 2, "bandwidth overhead"), 1.0);
+
+  // a section starting after the last tick has no bandwidth
+  stats.setLastTick(150);
+  ASSERT_EQ(value(stats.toString(), 2, "bandwidth overhead"), "nan");
+}
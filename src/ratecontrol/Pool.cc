@@ -28,20 +28,16 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include "ratecontrol/Receiver.h"
+#include "ratecontrol/Pool.h"
 
-#include <cassert>
+#include <sstream>
 
-#include "ratecontrol/Message.h"
-
-Receiver::Receiver(des::Simulator* _sim, const std::string& _name,
-                   const des::Model* _parent, u32 _id,
-                   const std::string& _queuing, Network* _network)
-    : Node(_sim, _name, _parent, _id, _queuing, _network) {}
-
-Receiver::~Receiver() {}
-
-void Receiver::recv(Message* _msg) {
-  assert(_msg->type == 0);  // Receivers only accept message type 0
-  delete _msg;
+std::string PoolStats::toString(const std::string& _name) const {
+  std::stringstream ss;
+  ss << _name << " pool allocs: " << allocs << '\n'
+     << _name << " pool frees: " << frees << '\n'
+     << _name << " pool live: " << live << '\n'
+     << _name << " pool peak: " << peak << '\n'
+     << _name << " pool bytes: " << bytes << '\n';
+  return ss.str();
 }
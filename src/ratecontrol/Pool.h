@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_POOL_H_
+#define RATECONTROL_POOL_H_
+
+#include <prim/prim.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * These are the statistics of a single object pool. 'peak' is the sum of the
+ *  per-thread peak live object counts. It is exact when run with a single
+ *  thread and bounds the true peak from above otherwise. 'bytes' is the memory
+ *  held in slabs.
+ */
+struct PoolStats {
+  u64 allocs;
+  u64 frees;
+  u64 live;
+  u64 peak;
+  u64 bytes;
+
+  std::string toString(const std::string& _name) const;
+};
+
+/*
+ * This is a per-thread slab/free-list allocator for fixed size objects of type
+ *  T. Each thread allocates from and frees to its own free list without any
+ *  locking. Objects freed by a thread other than the allocating thread simply
+ *  join the freeing thread's list. When a thread's list grows too large, a
+ *  batch is handed back to a shared depot which is consulted before any new
+ *  slab is created, thus memory does not drift between threads unboundedly.
+ */
+template <typename T>
+class Pool {
+ public:
+  static void* allocate();
+  static void deallocate(void* _ptr);
+  static PoolStats stats();
+
+ private:
+  union Slot {
+    Slot* next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  // the counters read by stats() are atomic as it may run on another thread
+  //  (i.e., the progress reporter), only the owning thread writes them
+  struct Cache {
+    Slot* freeList;
+    u64 freeCount;
+    std::atomic<u64> allocs;
+    std::atomic<u64> frees;
+    s64 live;
+    std::atomic<s64> peak;
+  };
+
+  struct Registry {
+    ~Registry();
+    std::mutex lock;
+    std::vector<Cache*> caches;
+    std::vector<Slot*> slabs;
+    std::vector<Slot*> depot;  // each entry is a chain of BATCH slots
+  };
+
+  static const u64 BATCH = sizeof(Slot) >= 256 ? 64 : 16384 / sizeof(Slot);
+
+  static Cache* cache();
+  static Registry& registry();
+  static void refill(Cache* _cache);
+  static void spill(Cache* _cache);
+
+  static thread_local Cache* cache_;
+};
+
+/*
+ * Inheriting from this class routes all 'new' and 'delete' calls of T to
+ *  Pool<T>. The call sites don't change.
+ */
+template <typename T>
+class Pooled {
+ public:
+  static void* operator new(std::size_t _size);
+  static void operator delete(void* _ptr);
+};
+
+#include "ratecontrol/Pool.tcc"
+
+#endif  // RATECONTROL_POOL_H_
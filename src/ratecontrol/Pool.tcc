@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_POOL_H_
+#error "do not include this file, include Pool.h instead"
+#endif  // RATECONTROL_POOL_H_
+
+#include <cassert>
+
+template <typename T>
+thread_local typename Pool<T>::Cache* Pool<T>::cache_ = nullptr;
+
+template <typename T>
+void* Pool<T>::allocate() {
+  Cache* c = cache();
+  if (c->freeList == nullptr) {
+    refill(c);
+  }
+  Slot* slot = c->freeList;
+  c->freeList = slot->next;
+  c->freeCount--;
+  c->allocs.store(c->allocs.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  c->live++;
+  if (c->live > c->peak.load(std::memory_order_relaxed)) {
+    c->peak.store(c->live, std::memory_order_relaxed);
+  }
+  return slot;
+}
+
+template <typename T>
+void Pool<T>::deallocate(void* _ptr) {
+  if (_ptr == nullptr) {
+    return;
+  }
+  Cache* c = cache();
+  Slot* slot = reinterpret_cast<Slot*>(_ptr);
+  slot->next = c->freeList;
+  c->freeList = slot;
+  c->freeCount++;
+  c->frees.store(c->frees.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+  c->live--;
+  if (c->freeCount >= 2 * BATCH) {
+    spill(c);
+  }
+}
+
+template <typename T>
+PoolStats Pool<T>::stats() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  PoolStats s = {0, 0, 0, 0, 0};
+  for (Cache* c : reg.caches) {
+    s.allocs += c->allocs.load(std::memory_order_relaxed);
+    s.frees += c->frees.load(std::memory_order_relaxed);
+    s.peak += c->peak.load(std::memory_order_relaxed);
+  }
+  // while threads are running, frees of objects allocated after their
+  //  allocating thread's counter was read can make the sum negative
+  s.live = s.allocs >= s.frees ? s.allocs - s.frees : 0;
+  s.bytes = reg.slabs.size() * BATCH * sizeof(Slot);
+  return s;
+}
+
+template <typename T>
+Pool<T>::Registry::~Registry() {
+  for (Slot* slab : slabs) {
+    delete[] slab;
+  }
+  for (Cache* c : caches) {
+    delete c;
+  }
+}
+
+template <typename T>
+typename Pool<T>::Cache* Pool<T>::cache() {
+  if (cache_ == nullptr) {
+    // the cache is owned by the registry so the stats outlive the thread
+    Cache* c = new Cache();
+    c->freeList = nullptr;
+    c->freeCount = 0;
+    c->allocs = 0;
+    c->frees = 0;
+    c->live = 0;
+    c->peak = 0;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.caches.push_back(c);
+    cache_ = c;
+  }
+  return cache_;
+}
+
+template <typename T>
+typename Pool<T>::Registry& Pool<T>::registry() {
+  static Registry reg;
+  return reg;
+}
+
+template <typename T>
+void Pool<T>::refill(Cache* _cache) {
+  assert(_cache->freeList == nullptr);
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+
+  // prefer a batch that another thread gave back
+  if (!reg.depot.empty()) {
+    _cache->freeList = reg.depot.back();
+    reg.depot.pop_back();
+    _cache->freeCount = BATCH;
+    return;
+  }
+
+  // carve a new slab
+  Slot* slab = new Slot[BATCH];
+  reg.slabs.push_back(slab);
+  for (u64 idx = 0; idx < BATCH - 1; idx++) {
+    slab[idx].next = &slab[idx + 1];
+  }
+  slab[BATCH - 1].next = nullptr;
+  _cache->freeList = slab;
+  _cache->freeCount = BATCH;
+}
+
+template <typename T>
+void Pool<T>::spill(Cache* _cache) {
+  // detach exactly one batch from the front of the free list
+  Slot* head = _cache->freeList;
+  Slot* tail = head;
+  for (u64 idx = 1; idx < BATCH; idx++) {
+    tail = tail->next;
+  }
+  _cache->freeList = tail->next;
+  _cache->freeCount -= BATCH;
+  tail->next = nullptr;
+
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  reg.depot.push_back(head);
+}
+
+template <typename T>
+void* Pooled<T>::operator new(std::size_t _size) {
+  assert(_size == sizeof(T));
+  (void)_size;  // unused with NDEBUG
+  return Pool<T>::allocate();
+}
+
+template <typename T>
+void Pooled<T>::operator delete(void* _ptr) {
+  Pool<T>::deallocate(_ptr);
+}
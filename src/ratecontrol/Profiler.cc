@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/Profiler.h"
+
+#include <cxxabi.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <utility>
+
+bool Profiler::enabled_ = false;
+u64 Profiler::startTicks_ = 0;
+std::chrono::steady_clock::time_point Profiler::startTime_;
+thread_local Profiler::Counters* Profiler::counters_ = nullptr;
+
+u32 Profiler::site(const std::type_info& _model, const std::string& _handler) {
+  // use the readable class name (i.e. "Relay<FifoQueuing>")
+  s32 status;
+  char* demangled = abi::__cxa_demangle(_model.name(), nullptr, nullptr,
+                                        &status);
+  std::string model = status == 0 ? demangled : _model.name();
+  free(demangled);
+
+  // the stats block is parsed as "name: value", so names can't hold a colon
+  std::replace(model.begin(), model.end(), ':', '.');
+
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  if (reg.models.size() == MAX_SITES) {
+    fprintf(stderr, "too many profiler sites\n");
+    exit(-1);
+  }
+  reg.models.push_back(model);
+  reg.handlers.push_back(_handler);
+  return reg.models.size() - 1;
+}
+
+void Profiler::enable() {
+  enabled_ = true;
+  startTicks_ = ticks();
+  startTime_ = std::chrono::steady_clock::now();
+}
+
+bool Profiler::enabled() {
+  return enabled_;
+}
+
+void Profiler::disable() {
+  enabled_ = false;
+}
+
+void Profiler::reset() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  for (Counters* c : reg.counters) {
+    std::fill(c->calls, c->calls + MAX_SITES, 0);
+    std::fill(c->ticks, c->ticks + MAX_SITES, 0);
+  }
+}
+
+u64 Profiler::calls(const std::string& _name) {
+  return totals(_name).calls;
+}
+
+f64 Profiler::seconds(const std::string& _name) {
+  return totals(_name).ticks * secondsPerTick();
+}
+
+std::string Profiler::toString() {
+  f64 secondsPerTick = Profiler::secondsPerTick();
+
+  // merge the counters of all threads
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  u32 numSites = reg.models.size();
+  std::vector<u64> calls(numSites, 0);
+  std::vector<u64> ticks(numSites, 0);
+  for (const Counters* c : reg.counters) {
+    for (u32 s = 0; s < numSites; s++) {
+      calls[s] += c->calls[s];
+      ticks[s] += c->ticks[s];
+    }
+  }
+
+  // aggregate the model classes
+  std::map<std::string, Totals> models;
+  for (u32 s = 0; s < numSites; s++) {
+    Totals& model = models[reg.models[s]];
+    model.calls += calls[s];
+    model.ticks += ticks[s];
+  }
+
+  // list the sites then the model classes, most time first
+  std::vector<std::pair<std::string, Totals> > entries;
+  for (u32 s = 0; s < numSites; s++) {
+    if (calls[s] > 0) {
+      entries.push_back(std::make_pair(
+          reg.models[s] + "." + reg.handlers[s], Totals{calls[s], ticks[s]}));
+    }
+  }
+  auto byTime = [](const std::pair<std::string, Totals>& _a,
+                   const std::pair<std::string, Totals>& _b) {
+    return _a.second.ticks > _b.second.ticks;
+  };
+  std::stable_sort(entries.begin(), entries.end(), byTime);
+  u32 numEntries = entries.size();
+  for (const std::pair<const std::string, Totals>& model : models) {
+    if (model.second.calls > 0) {
+      entries.push_back(model);
+    }
+  }
+  std::stable_sort(entries.begin() + numEntries, entries.end(), byTime);
+
+  std::stringstream ss;
+  u64 total = 0;
+  for (u32 e = 0; e < entries.size(); e++) {
+    ss << "Profile " << entries[e].first << " calls: "
+       << entries[e].second.calls << '\n'
+       << "Profile " << entries[e].first << " seconds: "
+       << entries[e].second.ticks * secondsPerTick << '\n';
+    if (e < numEntries) {
+      total += entries[e].second.ticks;
+    }
+  }
+  ss << "Profile total seconds: " << total * secondsPerTick << '\n';
+  return ss.str();
+}
+
+Profiler::Registry::~Registry() {
+  for (Counters* c : counters) {
+    delete c;
+  }
+}
+
+u64 Profiler::ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+f64 Profiler::secondsPerTick() {
+  // calibrate the ticks against the wall clock over the whole run
+  f64 seconds = std::chrono::duration<f64>(
+      std::chrono::steady_clock::now() - startTime_).count();
+  u64 elapsed = ticks() - startTicks_;
+  return elapsed > 0 ? seconds / elapsed : 0.0;
+}
+
+Profiler::Totals Profiler::totals(const std::string& _name) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.lock);
+  Totals totals = {0, 0};
+  for (u32 s = 0; s < reg.models.size(); s++) {
+    if (reg.models[s] + "." + reg.handlers[s] == _name) {
+      for (const Counters* c : reg.counters) {
+        totals.calls += c->calls[s];
+        totals.ticks += c->ticks[s];
+      }
+    }
+  }
+  return totals;
+}
+
+Profiler::Counters* Profiler::counters() {
+  if (counters_ == nullptr) {
+    // the counters are owned by the registry so they outlive the thread
+    Counters* c = new Counters();
+    std::fill(c->calls, c->calls + MAX_SITES, 0);
+    std::fill(c->ticks, c->ticks + MAX_SITES, 0);
+    c->top = nullptr;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.counters.push_back(c);
+    counters_ = c;
+  }
+  return counters_;
+}
+
+Profiler::Registry& Profiler::registry() {
+  static Registry reg;
+  return reg;
+}
+
+ProfileProbe::ProfileProbe(u32 _site)
+    : counters_(Profiler::enabled_ ? Profiler::counters() : nullptr),
+      parent_(nullptr), site_(_site), start_(0), children_(0) {
+  if (counters_ != nullptr) {
+    parent_ = counters_->top;
+    counters_->top = this;
+    start_ = Profiler::ticks();
+  }
+}
+
+ProfileProbe::~ProfileProbe() {
+  if (counters_ != nullptr) {
+    u64 elapsed = Profiler::ticks() - start_;
+    counters_->calls[site_]++;
+    counters_->ticks[site_] += elapsed - children_;
+    counters_->top = parent_;
+    if (parent_ != nullptr) {
+      parent_->children_ += elapsed;
+    }
+  }
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PROFILER_H_
+#define RATECONTROL_PROFILER_H_
+
+#include <prim/prim.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+class ProfileProbe;
+
+/*
+ * This is the self-profiling of the event handlers. Each instrumented handler
+ *  (or hot function called by handlers) is a site named by its model class
+ *  and function, i.e.
+ *  "Relay<FifoQueuing>.handle_recv". Names never contain a colon so the
+ *  stats block stays parseable. When enabled, each thread counts the calls
+ *  and accumulates the time of every site in its own counters without any
+ *  locking. The time of a site is its self time, the
+ *  time of nested sites (e.g. a direct call to handle_send()) is charged to
+ *  the nested site only. Time is measured in timestamp counter ticks and
+ *  converted to seconds at the end of the run.
+ */
+class Profiler {
+ public:
+  /*
+   * This registers a site and returns its index. It is meant to initialize a
+   *  function local static of the handler.
+   */
+  static u32 site(const std::type_info& _model, const std::string& _handler);
+
+  /*
+   * This enables the profiling. It must be called before the simulation
+   *  starts.
+   */
+  static void enable();
+  static bool enabled();
+
+  /*
+   * disable() stops the profiling and reset() clears the counters of all
+   *  threads. Neither may be called while the simulation runs.
+   */
+  static void disable();
+  static void reset();
+
+  /*
+   * These return the calls and the self time of the sites named '_name' (i.e.
+   *  "Relay<FifoQueuing>.handle_recv") summed over all threads.
+   */
+  static u64 calls(const std::string& _name);
+  static f64 seconds(const std::string& _name);
+
+  /*
+   * This formats the per-site and per-model class breakdown sorted by time.
+   */
+  static std::string toString();
+
+ private:
+  friend class ProfileProbe;
+
+  static const u32 MAX_SITES = 256;
+
+  struct Counters {
+    u64 calls[MAX_SITES];
+    u64 ticks[MAX_SITES];
+    ProfileProbe* top;  // the innermost active probe
+  };
+
+  struct Totals {
+    u64 calls;
+    u64 ticks;
+  };
+
+  struct Registry {
+    ~Registry();
+    std::mutex lock;
+    std::vector<std::string> models;
+    std::vector<std::string> handlers;
+    std::vector<Counters*> counters;
+  };
+
+  static u64 ticks();
+  static f64 secondsPerTick();
+  static Totals totals(const std::string& _name);
+  static Counters* counters();
+  static Registry& registry();
+
+  static bool enabled_;
+  static u64 startTicks_;
+  static std::chrono::steady_clock::time_point startTime_;
+  static thread_local Counters* counters_;
+};
+
+/*
+ * This measures one call of a site for its lifetime. It does nothing unless
+ *  the profiler is enabled.
+ */
+class ProfileProbe {
+ public:
+  explicit ProfileProbe(u32 _site);
+  ~ProfileProbe();
+
+ private:
+  Profiler::Counters* counters_;
+  ProfileProbe* parent_;
+  u32 site_;
+  u64 start_;
+  u64 children_;  // the ticks of nested probes
+};
+
+#endif  // RATECONTROL_PROFILER_H_
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/ProgressReporter.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sstream>
+
+#include "ratecontrol/MemoryStats.h"
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Network.h"
+#include "ratecontrol/Node.h"
+#include "ratecontrol/Pool.h"
+
+std::atomic<u64> ProgressReporter::tick_(0);
+
+ProgressReporter::ProgressReporter(
+    const Network* _network, const std::string& _destination, f64 _period,
+    des::Tick _endTick)
+    : network_(_network), period_(_period), endTick_(_endTick),
+      fd_(-1), socket_(false), stopping_(false) {
+  const std::string prefix = "unix:";
+  if (_destination.compare(0, prefix.size(), prefix) == 0) {
+    // connect to a listening Unix domain socket
+    std::string path = _destination.substr(prefix.size());
+    sockaddr_un addr;
+    if (path.size() >= sizeof(addr.sun_path)) {
+      fprintf(stderr, "progress socket path is too long: %s\n", path.c_str());
+      exit(-1);
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || connect(fd_, reinterpret_cast<sockaddr*>(&addr),
+                           sizeof(addr)) != 0) {
+      fprintf(stderr, "couldn't connect to progress socket: %s\n",
+              path.c_str());
+      exit(-1);
+    }
+    socket_ = true;
+  } else {
+    fd_ = open(_destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      fprintf(stderr, "couldn't open progress file: %s\n",
+              _destination.c_str());
+      exit(-1);
+    }
+  }
+}
+
+ProgressReporter::~ProgressReporter() {
+  stop();
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void ProgressReporter::start() {
+  tick_.store(0, std::memory_order_relaxed);
+  start_ = std::chrono::steady_clock::now();
+  thread_ = std::thread(&ProgressReporter::run, this);
+}
+
+void ProgressReporter::stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  thread_.join();
+}
+
+void ProgressReporter::executed(des::Tick _tick) {
+  // the shared tick is only written when it advances, which is rare compared
+  //  to the events. concurrent updates may briefly lose the latest tick
+  if (tick_.load(std::memory_order_relaxed) < _tick) {
+    tick_.store(_tick, std::memory_order_relaxed);
+  }
+}
+
+void ProgressReporter::run() {
+  Sample last = {0.0, 0, 0};
+  std::unique_lock<std::mutex> lock(lock_);
+  bool done = false;
+  while (!done) {
+    wake_.wait_for(lock, std::chrono::duration<f64>(period_),
+                   [this]() { return stopping_; });
+    done = stopping_;
+    lock.unlock();
+    last = report(last, done);
+    lock.lock();
+  }
+}
+
+ProgressReporter::Sample ProgressReporter::report(const Sample& _last,
+                                                  bool _done) {
+  Sample now;
+  now.wall = std::chrono::duration<f64>(
+      std::chrono::steady_clock::now() - start_).count();
+  now.tick = tick_.load(std::memory_order_relaxed);
+
+  // every executed node event frees its pooled event
+  now.events = Pool<MessageEvent>::stats().frees +
+      Pool<NodeEvent>::stats().frees + Pool<TimerEvent>::stats().frees;
+  u64 messages = Pool<Message>::stats().live;
+  u64 liveEvents = Pool<MessageEvent>::stats().live +
+      Pool<NodeEvent>::stats().live + Pool<TimerEvent>::stats().live;
+
+  // a node registered with a range of ids (i.e. a sender group) is only
+  //  counted once
+  u64 queued = 0;
+  u64 maxQueued = 0;
+  const Node* previous = nullptr;
+  for (u32 id = 0; id < network_->size(); id++) {
+    const Node* node = network_->getNode(id);
+    if (node == nullptr || node == previous) {
+      continue;
+    }
+    previous = node;
+    u64 depth = node->queued();
+    queued += depth;
+    if (depth > maxQueued) {
+      maxQueued = depth;
+    }
+  }
+
+  // the rates are of the last period
+  f64 elapsed = now.wall - _last.wall;
+  f64 eventRate = 0.0;
+  f64 tickRate = 0.0;
+  if (elapsed > 0.0) {
+    eventRate = (now.events - _last.events) / elapsed;
+    if (now.tick >= _last.tick) {
+      tickRate = (now.tick - _last.tick) / elapsed;
+    }
+  }
+
+  std::stringstream ss;
+  ss << "state=" << (_done ? "done" : "running")
+     << " wall=" << now.wall
+     << " tick=" << now.tick
+     << " events=" << now.events
+     << " events_per_second=" << eventRate
+     << " ticks_per_second=" << tickRate
+     << " messages=" << messages
+     << " live_events=" << liveEvents
+     << " queued=" << queued
+     << " max_queued=" << maxQueued
+     << " sender_queued_bytes="
+     << MemoryStats::queued(Bandwidth::SENDER).bytes
+     << " relay_queued_bytes="
+     << MemoryStats::queued(Bandwidth::RELAY).bytes
+     << " receiver_queued_bytes="
+     << MemoryStats::queued(Bandwidth::RECEIVER).bytes
+     << " eta=";
+  if (now.tick >= endTick_ || _done) {
+    ss << 0.0;
+  } else if (tickRate > 0.0) {
+    ss << (endTick_ - now.tick) / tickRate;
+  } else {
+    ss << '-';
+  }
+  ss << '\n';
+  write(ss.str());
+  return now;
+}
+
+void ProgressReporter::write(const std::string& _line) {
+  const char* data = _line.c_str();
+  u64 remaining = _line.size();
+  while (fd_ >= 0 && remaining > 0) {
+    // a closed socket must not raise SIGPIPE and end the simulation
+    ssize_t written = socket_ ?
+        send(fd_, data, remaining, MSG_NOSIGNAL) :
+        ::write(fd_, data, remaining);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      fprintf(stderr, "progress reporting failed, disabling it\n");
+      close(fd_);
+      fd_ = -1;
+      return;
+    }
+    data += written;
+    remaining -= written;
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_PROGRESSREPORTER_H_
+#define RATECONTROL_PROGRESSREPORTER_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Network;
+
+/*
+ * This is a background thread that periodically writes the progress of a
+ *  running simulation as one line of 'key=value' fields:
+ *   wall              wall seconds since start()
+ *   tick              the current simulated tick
+ *   events            the number of node events executed
+ *   events_per_second events per wall second over the last period
+ *   ticks_per_second  simulated ticks per wall second over the last period
+ *   messages          the number of live messages
+ *   live_events       the number of pending node events
+ *   queued            the number of messages waiting in node queues
+ *   max_queued        the largest number of messages waiting in one node
+ *   *_queued_bytes    the bytes waiting in the queues of each node class
+ *   eta               wall seconds until '_endTick' at the recent pace
+ * The values are read while the simulation runs without synchronizing with
+ *  it, thus they are approximate, but the simulation isn't perturbed. The
+ *  simulator's clock isn't safe to read from another thread, so the tick is
+ *  the latest one published by the node events through executed(). The
+ *  destination is a file or, prefixed with "unix:", a Unix domain stream
+ *  socket. A reporter that loses its socket stops reporting and lets the
+ *  simulation continue.
+ */
+class ProgressReporter {
+ public:
+  ProgressReporter(const Network* _network, const std::string& _destination,
+                   f64 _period, des::Tick _endTick);
+  ~ProgressReporter();
+
+  void start();
+
+  /*
+   * This writes a final line and joins the thread.
+   */
+  void stop();
+
+  /*
+   * This publishes the tick of an executed node event. The pooled node events
+   *  call it when they are deleted by their handler.
+   */
+  static void executed(des::Tick _tick);
+
+ private:
+  struct Sample {
+    f64 wall;
+    des::Tick tick;
+    u64 events;
+  };
+
+  void run();
+  Sample report(const Sample& _last, bool _done);
+  void write(const std::string& _line);
+
+  const Network* network_;
+  const f64 period_;
+  const des::Tick endTick_;
+  s32 fd_;
+  bool socket_;
+  std::chrono::steady_clock::time_point start_;
+  std::thread thread_;
+  std::mutex lock_;
+  std::condition_variable wake_;
+  bool stopping_;
+
+  static std::atomic<u64> tick_;  // the latest published tick
+};
+
+#endif  // RATECONTROL_PROGRESSREPORTER_H_
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_QUEUEDNODE_H_
+#define RATECONTROL_QUEUEDNODE_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <string>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Node.h"
+
+class Network;
+
+/*
+ * This implements the message pipeline of a node: an egress queue feeding a
+ *  serializing link and the delivery of received messages. 'Derived' is the
+ *  concrete node type (CRTP) and must provide a public 'void recv(Message*)'.
+ *  'Queuing' is the egress queuing discipline (see Queuing.h). Both are bound
+ *  at compile time so the per-message path has no virtual calls.
+ */
+template <typename Derived, typename Queuing>
+class QueuedNode : public Node {
+ public:
+  QueuedNode(des::Simulator* _sim, const std::string& _name,
+             const des::Model* _parent, u32 _id, Network* _network);
+  virtual ~QueuedNode();
+
+  u64 queued() const override;
+
+ protected:
+  /*
+   * This sends a message from this node at the next available time.
+   */
+  void send(Message* _msg);
+
+  /*
+   * This sends a message from this node at the next available time after
+   * the time specified. When the egress port is idle and the time is within
+   * the current tick, the message is transmitted immediately.
+   */
+  void send(Message* _msg, des::Time _time);
+
+ private:
+  void handle_recv(des::Event* _event);
+  void handle_enqueue(des::Event* _event);
+  void handle_send(des::Event* _event);
+
+  bool eventPending_;
+  Queuing queue_;
+};
+
+#include "ratecontrol/QueuedNode.tcc"
+
+#endif  // RATECONTROL_QUEUEDNODE_H_
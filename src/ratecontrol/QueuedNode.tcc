@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_QUEUEDNODE_H_
+#error "do not include this file, include QueuedNode.h instead"
+#endif  // RATECONTROL_QUEUEDNODE_H_
+
+#include <cassert>
+
+#include <typeinfo>
+
+#include "ratecontrol/MemoryStats.h"
+#include "ratecontrol/Network.h"
+#include "ratecontrol/PhaseStats.h"
+#include "ratecontrol/Profiler.h"
+#include "trace/TraceWriter.h"
+
+template <typename Derived, typename Queuing>
+QueuedNode<Derived, Queuing>::QueuedNode(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network)
+    : Node(_sim, _name, _parent, _id, _network,
+           static_cast<des::EventHandler>(&QueuedNode::handle_recv)),
+      eventPending_(false) {}
+
+template <typename Derived, typename Queuing>
+QueuedNode<Derived, Queuing>::~QueuedNode() {}
+
+template <typename Derived, typename Queuing>
+u64 QueuedNode<Derived, Queuing>::queued() const {
+  return queue_.size();
+}
+
+template <typename Derived, typename Queuing>
+void QueuedNode<Derived, Queuing>::send(Message* _msg) {
+  send(_msg, simulator->time().plusEps());
+}
+
+template <typename Derived, typename Queuing>
+void QueuedNode<Derived, Queuing>::send(Message* _msg, des::Time _time) {
+  if (!eventPending_ && queue_.empty() &&
+      _time.tick == simulator->time().tick) {
+    // fast path: the port is idle and the message would be transmitted in
+    //  this tick, transmit it now without the enqueue event. the receive time
+    //  only depends on the tick so the result is identical.
+    queue_.push(_msg);
+    MemoryStats::push(nodeClass_, _msg->size);
+    handle_send(nullptr);
+  } else {
+    // create and add the send message event
+    simulator->addEvent(new MessageEvent(
+        this, static_cast<des::EventHandler>(&QueuedNode::handle_enqueue),
+        _time, _msg));
+  }
+}
+
+template <typename Derived, typename Queuing>
+void QueuedNode<Derived, Queuing>::handle_recv(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(Derived), "handle_recv");
+  ProfileProbe probe(SITE);
+  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
+  dlogf("%s", evt->msg->toString().c_str());
+  if (trace_ != nullptr) {
+    trace_->write(simulator->time().tick, TraceRecord::RECV, id,
+                  evt->msg->src, evt->msg->size, evt->msg->trans,
+                  evt->msg->type);
+  }
+  if (bandwidth_ != nullptr) {
+    bandwidth_->recordRecv(nodeClass_, simulator->time().tick,
+                           evt->msg->size, evt->msg->type != Message::PLAIN);
+  }
+  if (phaseStats_ != nullptr && evt->msg->type != Message::PLAIN) {
+    // all control traffic is overhead
+    phaseStats_->recordOverhead(simulator->time().tick, evt->msg->size);
+  }
+  static_cast<Derived*>(this)->recv(evt->msg);
+  delete evt;
+}
+
+template <typename Derived, typename Queuing>
+void QueuedNode<Derived, Queuing>::handle_enqueue(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(Derived), "handle_enqueue");
+  ProfileProbe probe(SITE);
+  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
+  queue_.push(evt->msg);
+  MemoryStats::push(nodeClass_, evt->msg->size);
+  delete evt;
+
+  if (!eventPending_) {
+    handle_send(nullptr);
+  }
+}
+
+template <typename Derived, typename Queuing>
+void QueuedNode<Derived, Queuing>::handle_send(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(Derived), "handle_send");
+  ProfileProbe probe(SITE);
+  if (_event) {  // might be null due to direct call
+    assert(eventPending_);
+    delete _event;
+  } else {
+    assert(!eventPending_);
+  }
+
+  Message* msg = queue_.pop();
+  MemoryStats::pop(nodeClass_, msg->size);
+  bool more = !queue_.empty();
+
+  const Network::Entry& dst = network_->getEntry(msg->dst);
+  des::Time now = simulator->time();
+  des::Time recvTime(now + msg->size + dst.delay);
+  dst.node->future_recv(msg, recvTime);
+  dlogf("%s", msg->toString().c_str());
+  if (trace_ != nullptr) {
+    trace_->write(now.tick, TraceRecord::SEND, id, msg->dst, msg->size,
+                  msg->trans, msg->type);
+  }
+  if (bandwidth_ != nullptr) {
+    bandwidth_->recordSend(nodeClass_, now.tick, msg->size,
+                           msg->type != Message::PLAIN);
+  }
+
+  if (more) {
+    des::Time nextTime(now + msg->size);
+    simulator->addEvent(new NodeEvent(
+      this, static_cast<des::EventHandler>(&QueuedNode::handle_send),
+      nextTime));
+    eventPending_ = true;
+  } else {
+    eventPending_ = false;
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/Queuing.h"
+
+void FifoQueuing::push(Message* _msg) {
+  queue_.push(_msg);
+}
+
+Message* FifoQueuing::pop() {
+  Message* msg = queue_.front();
+  queue_.pop();
+  return msg;
+}
+
+bool FifoQueuing::empty() const {
+  return queue_.empty();
+}
+
+u64 FifoQueuing::size() const {
+  return queue_.size();
+}
+
+PriorityQueuing::PriorityQueuing() : size_(0) {}
+
+void PriorityQueuing::push(Message* _msg) {
+  queue_.push(_msg);
+  size_.store(queue_.size(), std::memory_order_relaxed);
+}
+
+Message* PriorityQueuing::pop() {
+  Message* msg = queue_.top();
+  queue_.pop();
+  size_.store(queue_.size(), std::memory_order_relaxed);
+  return msg;
+}
+
+bool PriorityQueuing::empty() const {
+  return queue_.empty();
+}
+
+u64 PriorityQueuing::size() const {
+  return size_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_QUEUING_H_
+#define RATECONTROL_QUEUING_H_
+
+#include <prim/prim.h>
+
+#include <atomic>
+#include <queue>
+#include <vector>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/MessageFifo.h"
+
+/*
+ * These are the egress queuing disciplines of a Node. They are selected at
+ *  compile time as a template parameter of QueuedNode. size() may be called
+ *  by other threads (i.e., the progress reporter) while the queue is used.
+ */
+class FifoQueuing {
+ public:
+  void push(Message* _msg);
+  Message* pop();
+  bool empty() const;
+  u64 size() const;
+
+ private:
+  MessageFifo queue_;
+};
+
+class PriorityQueuing {
+ public:
+  PriorityQueuing();
+
+  void push(Message* _msg);
+  Message* pop();
+  bool empty() const;
+  u64 size() const;
+
+ private:
+  std::priority_queue<Message*, std::vector<Message*>,
+                      MessagePriorityComparator> queue_;
+  std::atomic<u64> size_;  // mirrors queue_.size() for other threads
+};
+
+#endif  // RATECONTROL_QUEUING_H_
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/RateSchedule.h"
+
+#include <strop/strop.h>
+
+#include <cassert>
+
+#include <algorithm>
+#include <string>
+
+RateSchedule::RateSchedule(const Json::Value& _settings, u32 _numSenders) {
+  // check settings form
+  assert(_settings.isArray());
+
+  // process all entries in settings
+  //  expecting [des::Tick, std::string] pairs
+  for (const Json::Value& rateChange : _settings) {
+    // pull out the values
+    des::Tick tick(rateChange[0].asUInt64());
+    std::string control = rateChange[1].asString();
+
+    std::vector<std::string> groups = strop::split(control, ':');
+    for (const std::string& group : groups) {
+      std::vector<std::string> setting = strop::split(group, '=');
+      assert(setting.size() == 2);
+      const std::string& senderRange = setting.at(0);
+      f64 rate = std::stod(setting.at(1));
+      assert(rate >= 0.0 && rate <= 1.0);
+      u32 start;
+      u32 stop;
+      if (senderRange == "*") {
+        // full range
+        start = 1;
+        stop = _numSenders;
+      } else {
+        // a single specifier (i.e. "4") or a range (i.e. "4-89")
+        std::vector<std::string> startStop = strop::split(senderRange, '-');
+        assert(startStop.size() == 1 || startStop.size() == 2);
+        start = std::stoul(startStop.at(0));
+        stop = startStop.size() == 2 ? std::stoul(startStop.at(1)) : start;
+        assert(stop >= start);
+      }
+      assert(start >= 1 && stop <= _numSenders);
+      changes_.push_back({tick, start - 1, stop - 1, rate});
+    }
+  }
+
+  // sort by tick then sender, check that no tick is used twice and no
+  //  sender is set twice at the same tick
+  std::stable_sort(changes_.begin(), changes_.end(),
+                   [](const Change& _a, const Change& _b) {
+                     return _a.tick < _b.tick ||
+                         (_a.tick == _b.tick && _a.first < _b.first);
+                   });
+  for (u64 idx = 1; idx < changes_.size(); idx++) {
+    if (changes_[idx].tick == changes_[idx - 1].tick) {
+      assert(changes_[idx].first > changes_[idx - 1].last);
+    }
+  }
+  std::vector<des::Tick> ticks;
+  for (const Json::Value& rateChange : _settings) {
+    ticks.push_back(rateChange[0].asUInt64());
+  }
+  std::sort(ticks.begin(), ticks.end());
+  assert(std::adjacent_find(ticks.begin(), ticks.end()) == ticks.end());
+}
+
+RateSchedule::~RateSchedule() {}
+
+const std::vector<RateSchedule::Change>& RateSchedule::changes() const {
+  return changes_;
+}
+
+void RateSchedule::advance(u32 _index, des::Time _time, u32* _cursor,
+                           f64* _rate) const {
+  while (*_cursor < changes_.size()) {
+    const Change& change = changes_[*_cursor];
+    if (des::Time(change.tick, EPSILON) > _time) {
+      break;
+    }
+    if (_index >= change.first && _index <= change.last) {
+      *_rate = change.rate;
+    }
+    (*_cursor)++;
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_RATESCHEDULE_H_
+#define RATECONTROL_RATESCHEDULE_H_
+
+#include <des/des.h>
+#include <jsoncpp/json/json.h>
+#include <prim/prim.h>
+
+#include <vector>
+
+/*
+ * This is the injection rate schedule of the senders, parsed once from the
+ *  sender control settings into a table of (tick, sender range, rate)
+ *  entries sorted by tick. A change scheduled at tick T takes effect at
+ *  des::Time(T, EPSILON).
+ */
+class RateSchedule {
+ public:
+  struct Change {
+    des::Tick tick;
+    u32 first;  // sender index, inclusive
+    u32 last;  // sender index, inclusive
+    f64 rate;
+  };
+
+  RateSchedule(const Json::Value& _settings, u32 _numSenders);
+  ~RateSchedule();
+
+  const std::vector<Change>& changes() const;
+
+  /*
+   * This applies all changes for sender '_index' that are in effect at
+   *  '_time' to '_rate'. '_cursor' is the sender's position in the table
+   *  (start at 0), so the cost over a whole run is linear in the table size.
+   */
+  void advance(u32 _index, des::Time _time, u32* _cursor, f64* _rate) const;
+
+  static const des::Epsilon EPSILON = 1;
+
+ private:
+  std::vector<Change> changes_;
+};
+
+#endif  // RATECONTROL_RATESCHEDULE_H_
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <des/des.h>
+#include <jsoncpp/json/json.h>
+#include <prim/prim.h>
+
+#include <cassert>
+
+#include <string>
+#include <vector>
+
+#include "ratecontrol/RateSchedule.h"
+
+namespace {
+
+Json::Value parse(const std::string& _json) {
+  Json::Value value;
+  Json::Reader reader;
+  bool ok = reader.parse(_json, value);
+  assert(ok);
+  (void)ok;  // unused with NDEBUG
+  return value;
+}
+
+// this returns the rate of sender '_index' at '_time' starting from scratch
+f64 rateAt(const RateSchedule& _schedule, u32 _index, des::Time _time) {
+  u32 cursor = 0;
+  f64 rate = 0.0;
+  _schedule.advance(_index, _time, &cursor, &rate);
+  return rate;
+}
+
+}  // namespace
+
+TEST(RateSchedule, table) {
+  // the entries are out of order, the table is sorted by tick then sender
+  RateSchedule schedule(parse(
+      "[[50, \"1-5=0.0:6-10=0.8\"], [0, \"*=0.4\"],"
+      " [10, \"7=0.9:2-3=0.5\"]]"), 10);
+  const std::vector<RateSchedule::Change>& changes = schedule.changes();
+  ASSERT_EQ(changes.size(), 5u);
+  const RateSchedule::Change expected[] = {
+    {0, 0, 9, 0.4},
+    {10, 1, 2, 0.5},
+    {10, 6, 6, 0.9},
+    {50, 0, 4, 0.0},
+    {50, 5, 9, 0.8}};
+  for (u32 idx = 0; idx < 5; idx++) {
+    ASSERT_EQ(changes[idx].tick, expected[idx].tick) << idx;
+    ASSERT_EQ(changes[idx].first, expected[idx].first) << idx;
+    ASSERT_EQ(changes[idx].last, expected[idx].last) << idx;
+    ASSERT_EQ(changes[idx].rate, expected[idx].rate) << idx;
+  }
+}
+
+TEST(RateSchedule, epsilon) {
+  // a change at tick T takes effect at (T, EPSILON)
+  RateSchedule schedule(parse("[[0, \"*=0.4\"], [100, \"*=0.8\"]]"), 4);
+  ASSERT_EQ(rateAt(schedule, 0, des::Time(0, 0)), 0.0);
+  ASSERT_EQ(rateAt(schedule, 0, des::Time(0, RateSchedule::EPSILON)), 0.4);
+  ASSERT_EQ(rateAt(schedule, 3, des::Time(100, 0)), 0.4);
+  ASSERT_EQ(rateAt(schedule, 3, des::Time(100, RateSchedule::EPSILON)), 0.8);
+  ASSERT_EQ(rateAt(schedule, 3, des::Time(1000)), 0.8);
+}
+
+TEST(RateSchedule, ranges) {
+  RateSchedule schedule(parse(
+      "[[0, \"*=0.4\"], [10, \"2-3=0.5:5=0.9\"]]"), 6);
+  const f64 expected[] = {0.4, 0.5, 0.5, 0.4, 0.9, 0.4};
+  for (u32 sender = 0; sender < 6; sender++) {
+    ASSERT_EQ(rateAt(schedule, sender, des::Time(20)), expected[sender])
+        << sender;
+  }
+}
+
+TEST(RateSchedule, incremental) {
+  // advancing step by step gives the same rates as advancing from scratch
+  RateSchedule schedule(parse(
+      "[[0, \"*=0.4\"], [10, \"1-2=0.8:3-4=0.0\"],"
+      " [50, \"1-2=0.0:3-4=0.8\"], [90, \"*=0.4\"]]"), 4);
+  for (u32 sender = 0; sender < 4; sender++) {
+    u32 cursor = 0;
+    f64 rate = 0.0;
+    for (des::Tick tick = 0; tick < 120; tick += 7) {
+      des::Time time(tick, RateSchedule::EPSILON);
+      schedule.advance(sender, time, &cursor, &rate);
+      ASSERT_EQ(rate, rateAt(schedule, sender, time))
+          << "sender=" << sender << " tick=" << tick;
+      ASSERT_LE(cursor, schedule.changes().size());
+    }
+    ASSERT_EQ(cursor, schedule.changes().size());
+  }
+}
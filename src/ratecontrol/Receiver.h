@@ -36,19 +36,28 @@
 
 #include <string>
 
-#include "ratecontrol/Node.h"
+#include "ratecontrol/QueuedNode.h"
 
 class Message;
 class Network;
 
-class Receiver : public Node {
+template <typename Queuing>
+class Receiver : public QueuedNode<Receiver<Queuing>, Queuing> {
+ private:
+  typedef QueuedNode<Receiver<Queuing>, Queuing> Base;
+
  public:
   Receiver(des::Simulator* _sim, const std::string& _name,
-           const des::Model* _parent, u32 _id, const std::string& _queuing,
-           Network* _network);
+           const des::Model* _parent, u32 _id, Network* _network);
   ~Receiver();
 
-  void recv(Message* _msg) override;
+  void recv(Message* _msg);
+
+ private:
+  using Base::simulator;
+  using Base::phaseStats_;
 };
 
+#include "ratecontrol/Receiver.tcc"
+
 #endif  // RATECONTROL_RECEIVER_H_
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_RECEIVER_H_
+#error "do not include this file, include Receiver.h instead"
+#endif  // RATECONTROL_RECEIVER_H_
+
+#include <cassert>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/PhaseStats.h"
+
+template <typename Queuing>
+Receiver<Queuing>::Receiver(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network)
+    : Base(_sim, _name, _parent, _id, _network) {}
+
+template <typename Queuing>
+Receiver<Queuing>::~Receiver() {}
+
+template <typename Queuing>
+void Receiver<Queuing>::recv(Message* _msg) {
+  assert(_msg->type == 0);  // Receivers only accept message type 0
+  if (phaseStats_ != nullptr) {
+    // the message priority holds the creation tick of the transaction
+    des::Tick now = simulator->time().tick;
+    assert(now >= _msg->priority + _msg->size);
+    phaseStats_->recordLatency(now, now - _msg->priority - _msg->size);
+  }
+  delete _msg;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/ReceiverSink.h"
+
+#include <cassert>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <typeinfo>
+
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Network.h"
+#include "ratecontrol/PhaseStats.h"
+#include "ratecontrol/Profiler.h"
+#include "trace/TraceWriter.h"
+
+ReceiverSink::ReceiverSink(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _firstId, u32 _receivers, Network* _network)
+    : Node(_sim, _name, _parent, _firstId, _network,
+           static_cast<des::EventHandler>(&ReceiverSink::handle_recv)),
+      receivers(_receivers), messages_(_receivers, 0), bytes_(_receivers, 0),
+      latencySum_(_receivers, 0), latencyMax_(_receivers, 0) {
+  assert(receivers > 0);
+
+  // the first id is registered by Node
+  network_->registerRange(id + 1, receivers - 1, this);
+}
+
+ReceiverSink::~ReceiverSink() {}
+
+std::string ReceiverSink::toString(const std::vector<ReceiverSink*>& _sinks) {
+  u64 numReceivers = 0;
+  u64 minMessages = std::numeric_limits<u64>::max();
+  u64 maxMessages = 0;
+  u64 totalMessages = 0;
+  u64 totalBytes = 0;
+  u64 totalLatency = 0;
+  u64 maxLatency = 0;
+  for (const ReceiverSink* sink : _sinks) {
+    numReceivers += sink->receivers;
+    for (u32 r = 0; r < sink->receivers; r++) {
+      minMessages = std::min(minMessages, sink->messages_[r]);
+      maxMessages = std::max(maxMessages, sink->messages_[r]);
+      totalMessages += sink->messages_[r];
+      totalBytes += sink->bytes_[r];
+      totalLatency += sink->latencySum_[r];
+      maxLatency = std::max(maxLatency, sink->latencyMax_[r]);
+    }
+  }
+  assert(numReceivers > 0);
+
+  // one "name: value" line per value, as parser/RawData.py reads the stats
+  std::stringstream ss;
+  ss << "Receiver sink receivers: " << numReceivers << '\n'
+     << "Receiver sink messages total: " << totalMessages << '\n'
+     << "Receiver sink messages min: " << minMessages << '\n'
+     << "Receiver sink messages mean: "
+     << ((f64)totalMessages / numReceivers) << '\n'
+     << "Receiver sink messages max: " << maxMessages << '\n'
+     << "Receiver sink bytes total: " << totalBytes << '\n'
+     << "Receiver sink latency mean: "
+     << (totalMessages > 0 ? (f64)totalLatency / totalMessages : 0.0) << '\n'
+     << "Receiver sink latency max: " << maxLatency << '\n';
+  return ss.str();
+}
+
+void ReceiverSink::handle_recv(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(ReceiverSink), "handle_recv");
+  ProfileProbe probe(SITE);
+  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
+  Message* msg = evt->msg;
+  delete evt;
+  dlogf("%s", msg->toString().c_str());
+  des::Tick now = simulator->time().tick;
+  if (trace_ != nullptr) {
+    trace_->write(now, TraceRecord::RECV, msg->dst, msg->src, msg->size,
+                  msg->trans, msg->type);
+  }
+  if (bandwidth_ != nullptr) {
+    bandwidth_->recordRecv(nodeClass_, now, msg->size, false);
+  }
+
+  assert(msg->type == Message::PLAIN);  // receivers only accept plain
+  u32 receiver = msg->dst - id;
+  assert(receiver < receivers);
+
+  // the message priority holds the creation tick of the transaction
+  assert(now >= msg->priority + msg->size);
+  u64 latency = now - msg->priority - msg->size;
+  messages_[receiver]++;
+  bytes_[receiver] += msg->size;
+  latencySum_[receiver] += latency;
+  latencyMax_[receiver] = std::max(latencyMax_[receiver], latency);
+  if (phaseStats_ != nullptr) {
+    phaseStats_->recordLatency(now, latency);
+  }
+  delete msg;
+}
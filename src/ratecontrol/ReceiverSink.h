@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_RECEIVERSINK_H_
+#define RATECONTROL_RECEIVERSINK_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+#include "ratecontrol/Node.h"
+
+class Network;
+
+/*
+ * This is a single model standing in for a range of receivers with
+ *  consecutive ids. Receivers never send, so all they need is the receive
+ *  path of QueuedNode and their counters, which are kept in flat arrays
+ *  indexed by the receiver's offset in the range. The results are identical
+ *  to using one Receiver per id.
+ *
+ * A model's events are serialized, so the receivers are split over several
+ *  sinks (shards) to let the simulator execute receives in parallel.
+ */
+class ReceiverSink : public Node {
+ public:
+  ReceiverSink(des::Simulator* _sim, const std::string& _name,
+               const des::Model* _parent, u32 _firstId, u32 _receivers,
+               Network* _network);
+  ~ReceiverSink();
+
+  /*
+   * This summarizes the per-receiver counters of all shards as "name: value"
+   *  lines for the stats block of the log.
+   */
+  static std::string toString(const std::vector<ReceiverSink*>& _sinks);
+
+  const u32 receivers;  // the number of logical receivers
+
+ private:
+  void handle_recv(des::Event* _event);
+
+  // per logical receiver counters
+  std::vector<u64> messages_;
+  std::vector<u64> bytes_;
+  std::vector<u64> latencySum_;
+  std::vector<u64> latencyMax_;
+};
+
+#endif  // RATECONTROL_RECEIVERSINK_H_
@@ -36,31 +36,35 @@
 
 #include <string>
 
-#include "ratecontrol/Node.h"
+#include "ratecontrol/QueuedNode.h"
 
 class Message;
 class Network;
 
-class Relay : public Node {
- public:
-  struct Request {
-    u64 reqId;
-    u32 msgDst;
-  };
-  struct Response {
-    u64 reqId;
-  };
+template <typename Queuing>
+class Relay : public QueuedNode<Relay<Queuing>, Queuing> {
+ private:
+  typedef QueuedNode<Relay<Queuing>, Queuing> Base;
 
+ public:
   Relay(des::Simulator* _sim, const std::string& _name,
-        const des::Model* _parent, u32 _id, const std::string& _queuing,
-        Network* _network, f64 _rate);
+        const des::Model* _parent, u32 _id, Network* _network, f64 _rate);
   ~Relay();
 
   void recv(Message* _msg);
 
+  using Base::id;
+  using Base::debug;
+
  private:
+  using Base::simulator;
+  using Base::send;
+  using Base::cyclesToSend;
+
   const f64 rate_;
   des::Time nextTime_;
 };
 
+#include "ratecontrol/Relay.tcc"
+
 #endif  // RATECONTROL_RELAY_H_
@@ -28,23 +28,27 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include "ratecontrol/Relay.h"
+#ifndef RATECONTROL_RELAY_H_
+#error "do not include this file, include Relay.h instead"
+#endif  // RATECONTROL_RELAY_H_
 
 #include <cassert>
 
 #include "ratecontrol/Message.h"
 
-Relay::Relay(des::Simulator* _sim, const std::string& _name,
-             const des::Model* _parent, u32 _id, const std::string& _queuing,
-             Network* _network, f64 _rate)
-    : Node(_sim, _name, _parent, _id, _queuing, _network), rate_(_rate),
-      nextTime_(0) {
+template <typename Queuing>
+Relay<Queuing>::Relay(des::Simulator* _sim, const std::string& _name,
+                      const des::Model* _parent, u32 _id, Network* _network,
+                      f64 _rate)
+    : Base(_sim, _name, _parent, _id, _network), rate_(_rate), nextTime_(0) {
   assert(rate_ > 0.0 && rate_ <= 1.0);
 }
 
-Relay::~Relay() {}
+template <typename Queuing>
+Relay<Queuing>::~Relay() {}
 
-void Relay::recv(Message* _msg) {
+template <typename Queuing>
+void Relay<Queuing>::recv(Message* _msg) {
   assert(_msg->type == Message::RELAY_REQUEST);
 
   // determine when the message will be sent
@@ -52,19 +56,15 @@ void Relay::recv(Message* _msg) {
   nextTime_ = des::Time::max(nextTime_, now.plusEps());  // NOLINT
 
   // create a response for the source
-  Request* req = reinterpret_cast<Request*>(_msg->data);
-  Response* resp = new Response();
-  resp->reqId = req->reqId;
+  const RelayRequest* req = _msg->relayRequest();
   Message* respMsg = new Message(id, _msg->src, 1, _msg->trans,
-                                 Message::RELAY_RESPONSE, resp,
-                                 _msg->priority);
+                                 Message::RELAY_RESPONSE, _msg->priority);
+  respMsg->relayResponse()->reqId = req->reqId;
 
   // reformat the message for the real destination
   _msg->dst = req->msgDst;
   _msg->size -= 1;
   _msg->type = Message::PLAIN;
-  _msg->data = nullptr;
-  delete req;
 
   // send both messages
   send(respMsg, nextTime_);
@@ -31,31 +31,41 @@
 #ifndef RATECONTROL_RELAYSENDER_H_
 #define RATECONTROL_RELAYSENDER_H_
 
-#include <jsoncpp/json/json.h>
 #include <prim/prim.h>
 
-#include <queue>
 #include <string>
 
+#include "ratecontrol/MessageFifo.h"
 #include "ratecontrol/Sender.h"
+#include "ratecontrol/SenderConfig.h"
 
 class Message;
 class Network;
-class Relay;
 
-class RelaySender : public Sender {
+template <typename Queuing>
+class RelaySender : public Sender<RelaySender<Queuing>, Queuing> {
+ private:
+  typedef Sender<RelaySender<Queuing>, Queuing> Base;
+  friend Base;
+
  public:
   RelaySender(des::Simulator* _sim, const std::string& _name,
-              const des::Model* _parent, u32 _id, const std::string& _queuing,
-              Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
-              u32 _receiverMinId, u32 _receiverMaxId, Json::Value _settings);
+              const des::Model* _parent, u32 _id, Network* _network,
+              u32 _minMessageSize, u32 _maxMessageSize, u32 _receiverMinId,
+              u32 _receiverMaxId, f64 _rateLimit,
+              const SenderConfig* _config);
   ~RelaySender();
   void relayIds(u32 _relayMinId, u32 _relayMaxId);
 
-  void recv(Message* _msg) override;
+  void recv(Message* _msg);
+  u64 queued() const override;
 
  protected:
-  void sendMessage(Message* _msg) override;
+  using Base::prng;
+  using Base::send;
+  using Base::nodeClass_;
+
+  void sendMessage(Message* _msg);
   void processQueue();
 
  private:
@@ -65,8 +75,10 @@ class RelaySender : public Sender {
   u64 relayReqId_;
   const u32 maxOutstanding_;
 
-  std::queue<Message*> sendQueue_;
+  MessageFifo sendQueue_;
   u32 credits_;
 };
 
+#include "ratecontrol/RelaySender.tcc"
+
 #endif  // RATECONTROL_RELAYSENDER_H_
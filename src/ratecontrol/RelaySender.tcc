@@ -28,38 +28,42 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include "ratecontrol/RelaySender.h"
+#ifndef RATECONTROL_RELAYSENDER_H_
+#error "do not include this file, include RelaySender.h instead"
+#endif  // RATECONTROL_RELAYSENDER_H_
 
 #include <cassert>
 
+#include "ratecontrol/MemoryStats.h"
 #include "ratecontrol/Message.h"
-#include "ratecontrol/Relay.h"
 
-RelaySender::RelaySender(des::Simulator* _sim, const std::string& _name,
-                         const des::Model* _parent, u32 _id,
-                         const std::string& _queuing, Network* _network,
-                         u32 _minMessageSize, u32 _maxMessageSize,
-                         u32 _receiverMinId, u32 _receiverMaxId,
-                         Json::Value _settings)
-    : Sender(_sim, _name, _parent, _id, _queuing, _network, _minMessageSize,
-             _maxMessageSize, _receiverMinId, _receiverMaxId),
+template <typename Queuing>
+RelaySender<Queuing>::RelaySender(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
+    u32 _receiverMinId, u32 _receiverMaxId, f64 _rateLimit,
+    const SenderConfig* _config)
+    : Base(_sim, _name, _parent, _id, _network, _minMessageSize,
+           _maxMessageSize, _receiverMinId, _receiverMaxId),
       relayReqId_(0),
-      maxOutstanding_(_settings["max_outstanding"].asUInt()),
-      credits_(_settings["max_outstanding"].asUInt()) {
-  assert(!_settings["max_outstanding"].isNull());
-  assert(maxOutstanding_ > 0);
+      maxOutstanding_(_config->maxOutstanding),
+      credits_(_config->maxOutstanding) {
+  assert(maxOutstanding_ > 0);  // verified by SenderConfig
+  (void)_rateLimit;  // unused
 }
 
-RelaySender::~RelaySender() {}
+template <typename Queuing>
+RelaySender<Queuing>::~RelaySender() {}
 
-void RelaySender::relayIds(u32 _relayMinId, u32 _relayMaxId) {
+template <typename Queuing>
+void RelaySender<Queuing>::relayIds(u32 _relayMinId, u32 _relayMaxId) {
   relayMinId_ = _relayMinId;
   relayMaxId_ = _relayMaxId;
 }
 
-void RelaySender::recv(Message* _msg) {
+template <typename Queuing>
+void RelaySender<Queuing>::recv(Message* _msg) {
   assert(_msg->type == Message::RELAY_RESPONSE);
-  delete reinterpret_cast<Relay::Response*>(_msg->data);
   delete _msg;
 
   // decrement the outstanding count for this recv
@@ -70,30 +74,39 @@ void RelaySender::recv(Message* _msg) {
   processQueue();
 }
 
-void RelaySender::sendMessage(Message* _msg) {
+template <typename Queuing>
+u64 RelaySender<Queuing>::queued() const {
+  return Base::queued() + sendQueue_.size();
+}
+
+template <typename Queuing>
+void RelaySender<Queuing>::sendMessage(Message* _msg) {
   // reformat the message to be a relay request
-  Relay::Request* req = new Relay::Request();
-  req->reqId = relayReqId_;
-  relayReqId_++;
-  req->msgDst = _msg->dst;
+  u32 msgDst = _msg->dst;
   _msg->dst = prng.nextU64(relayMinId_, relayMaxId_);
   _msg->size++;  // increase for request header
   _msg->type = Message::RELAY_REQUEST;
-  _msg->data = req;
+  RelayRequest* req = _msg->relayRequest();
+  req->reqId = relayReqId_;
+  relayReqId_++;
+  req->msgDst = msgDst;
 
   // add to queue
   sendQueue_.push(_msg);
+  MemoryStats::push(nodeClass_, _msg->size);
 
   // process the send queue
   processQueue();
 }
 
-void RelaySender::processQueue() {
+template <typename Queuing>
+void RelaySender<Queuing>::processQueue() {
   // send all available messages
   while (!sendQueue_.empty() && credits_ > 0) {
     // pop the next message
     Message* _msg = sendQueue_.front();
     sendQueue_.pop();
+    MemoryStats::pop(nodeClass_, _msg->size);
 
     // send the message
     send(_msg);
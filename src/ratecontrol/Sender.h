@@ -36,39 +36,70 @@
 
 #include <string>
 
-#include "ratecontrol/Node.h"
+#include "ratecontrol/QueuedNode.h"
+#include "ratecontrol/RateSchedule.h"
 
+class Message;
 class Network;
-class Receiver;
 
-class Sender : public Node {
+/*
+ * This is the message generator common to all sender algorithms. 'Derived' is
+ *  the concrete sender (CRTP) and must provide 'void sendMessage(Message*)'
+ *  which is called for every newly generated message.
+ */
+template <typename Derived, typename Queuing>
+class Sender : public QueuedNode<Derived, Queuing> {
+ private:
+  typedef QueuedNode<Derived, Queuing> Base;
+
  public:
   Sender(des::Simulator* _sim, const std::string& _name,
-         const des::Model* _parent, u32 _id, const std::string& _queuing,
-         Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
-         u32 _receiverMinId, u32 _receiverMaxId);
+         const des::Model* _parent, u32 _id, Network* _network,
+         u32 _minMessageSize, u32 _maxMessageSize, u32 _receiverMinId,
+         u32 _receiverMaxId);
   virtual ~Sender();
 
-  void setInjectionRate(f64 _rate);
-  f64 getInjectionRate() const;
+  /*
+   * This sets the schedule the injection rate is taken from, '_index' is the
+   *  sender's position in it. The rate is read from the schedule whenever a
+   *  message is generated.
+   */
+  void setRateSchedule(const RateSchedule* _schedule, u32 _index);
 
- protected:
   /*
-   * Subclasses must override this to implement custom send algorithms.
+   * This starts message generation at '_time' for a sender whose rate turns
+   *  on, '_index' is the sender's position in the schedule. It only adds an
+   *  event so it may be called by another model.
    */
-  virtual void sendMessage(Message* _msg) = 0;
+  void startInjection(u32 _index, des::Time _time);
+
+  f64 getInjectionRate() const;
+
+  using Base::id;
+  using Base::debug;
+
+ protected:
+  using Base::simulator;
+  using Base::prng;
+  using Base::send;
+  using Base::cyclesToSend;
+  using Base::trace_;
 
   const u32 minMessageSize;
   const u32 maxMessageSize;
 
  private:
-  void handle_injectionRateEvent(des::Event* _event);
   void handle_sendMessage(des::Event* _event);
 
+  const RateSchedule* schedule_;
+  u32 scheduleIndex_;
+  u32 scheduleCursor_;
   f64 injectionRate_;
   const u32 receiverMinId_;
   const u32 receiverMaxId_;
   u32 messageCount_;
 };
 
+#include "ratecontrol/Sender.tcc"
+
 #endif  // RATECONTROL_SENDER_H_
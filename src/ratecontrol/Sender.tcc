@@ -28,82 +28,82 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include "ratecontrol/Sender.h"
+#ifndef RATECONTROL_SENDER_H_
+#error "do not include this file, include Sender.h instead"
+#endif  // RATECONTROL_SENDER_H_
 
 #include <cassert>
 
+#include <typeinfo>
+
 #include "ratecontrol/Message.h"
-#include "ratecontrol/Receiver.h"
+#include "ratecontrol/Profiler.h"
+#include "trace/TraceWriter.h"
 
-Sender::Sender(des::Simulator* _sim, const std::string& _name,
-               const des::Model* _parent, u32 _id, const std::string& _queuing,
-               Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
-               u32 _receiverMinId, u32 _receiverMaxId)
-    : Node(_sim, _name, _parent, _id, _queuing, _network),
+template <typename Derived, typename Queuing>
+Sender<Derived, Queuing>::Sender(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _id, Network* _network, u32 _minMessageSize, u32 _maxMessageSize,
+    u32 _receiverMinId, u32 _receiverMaxId)
+    : Base(_sim, _name, _parent, _id, _network),
       minMessageSize(_minMessageSize), maxMessageSize(_maxMessageSize),
+      schedule_(nullptr), scheduleIndex_(0), scheduleCursor_(0),
       injectionRate_(0.0), receiverMinId_(_receiverMinId),
       receiverMaxId_(_receiverMaxId), messageCount_(0) {}
 
-Sender::~Sender() {}
+template <typename Derived, typename Queuing>
+Sender<Derived, Queuing>::~Sender() {}
 
-void Sender::setInjectionRate(f64 _rate) {
-  assert(_rate >= 0.0 && _rate <= 1.0);
-  simulator->addEvent(new des::ItemEvent<f64>(
-      this, static_cast<des::EventHandler>(&Sender::handle_injectionRateEvent),
-      simulator->time().plusEps(), _rate));
+template <typename Derived, typename Queuing>
+void Sender<Derived, Queuing>::setRateSchedule(const RateSchedule* _schedule,
+                                               u32 _index) {
+  schedule_ = _schedule;
+  scheduleIndex_ = _index;
+  scheduleCursor_ = 0;
 }
 
-f64 Sender::getInjectionRate() const {
-  return injectionRate_;
+template <typename Derived, typename Queuing>
+void Sender<Derived, Queuing>::startInjection(u32 _index, des::Time _time) {
+  assert(_index == scheduleIndex_);
+  (void)_index;  // unused with NDEBUG
+  simulator->addEvent(new NodeEvent(
+      this, static_cast<des::EventHandler>(&Sender::handle_sendMessage),
+      _time));
 }
 
-void Sender::handle_injectionRateEvent(des::Event* _event) {
-  des::ItemEvent<f64>* evt = reinterpret_cast<des::ItemEvent<f64>*>(_event);
-  bool turnOn = injectionRate_ == 0.0 && evt->item > 0.0;
-  injectionRate_ = evt->item;
-  delete _event;
-
-  // if turning on, create an event
-  if (turnOn) {
-    simulator->addEvent(new des::Event(
-        this, static_cast<des::EventHandler>(&Sender::handle_sendMessage),
-        simulator->time().plusEps()));
-  }
+template <typename Derived, typename Queuing>
+f64 Sender<Derived, Queuing>::getInjectionRate() const {
+  return injectionRate_;
 }
 
-void Sender::handle_sendMessage(des::Event* _event) {
+template <typename Derived, typename Queuing>
+void Sender<Derived, Queuing>::handle_sendMessage(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(Derived), "handle_sendMessage");
+  ProfileProbe probe(SITE);
+  // apply any rate changes that have taken effect
+  schedule_->advance(scheduleIndex_, simulator->time(), &scheduleCursor_,
+                     &injectionRate_);
+
   // create and send a message
   u32 dst = prng.nextU64(receiverMinId_, receiverMaxId_);
   u32 size = prng.nextU64(minMessageSize, maxMessageSize);
   u64 trans = ((u64)id << 32) | ((u64)messageCount_);
   dlogf("trans=%lu size=%u", trans, size);
+  if (trace_ != nullptr) {
+    trace_->write(simulator->time().tick, TraceRecord::CREATE, id, dst, size,
+                  trans, Message::PLAIN);
+  }
   messageCount_++;
-  Message* msg = new Message(id, dst, size, trans, Message::PLAIN, nullptr,
+  Message* msg = new Message(id, dst, size, trans, Message::PLAIN,
                              simulator->time().tick);
-  sendMessage(msg);
+  static_cast<Derived*>(this)->sendMessage(msg);
 
   // create an event to send the next message
   if (injectionRate_ > 0.0) {  // && messageCount_ < 1) {
-    simulator->addEvent(new des::Event(
+    simulator->addEvent(new NodeEvent(
         this, static_cast<des::EventHandler>(&Sender::handle_sendMessage),
         simulator->time() + cyclesToSend(size, injectionRate_)));
   }
 
   delete _event;
 }
-
-/*
-Message* Sender::getNextMessage() {
-  // std::atomic<u64> remaining_;
-  s64 prev = remaining_->fetch_sub(1);
-  if (prev > 0) {
-    u32 dst = prng.nextU64(receiverMinId_, receiverMaxId_);
-    u32 size = prng.nextU64(minMessageSize, maxMessageSize);
-    Message* msg = new Message(id, dst, size, (u64)prev, Message::PLAIN,
-                               nullptr);
-    return msg;
-  } else {
-    return nullptr;
-  }
-}
-*/
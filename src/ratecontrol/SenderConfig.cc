@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/SenderConfig.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#include "ratecontrol/PeerSelector.h"
+
+namespace {
+// this describes the values accepted as '_type'
+const char* typeName(Json::ValueType _type) {
+  switch (_type) {
+    case Json::uintValue:
+      return "an unsigned 32-bit integer";
+    case Json::realValue:
+      return "a number";
+    case Json::stringValue:
+      return "a string";
+    case Json::booleanValue:
+      return "a boolean";
+    default:
+      assert(false);
+      return nullptr;
+  }
+}
+
+// this returns the field at a dotted path (i.e. "params.max_tokens") of the
+//  sender configuration. a missing required field or a value that isn't
+//  convertible to '_type' ends the program.
+const Json::Value& field(const Json::Value& _config, const std::string& _path,
+                         bool _required, Json::ValueType _type) {
+  static const Json::Value NONE;
+  const Json::Value* value = &_config;
+  size_t start = 0;
+  while (start <= _path.size()) {
+    size_t stop = _path.find('.', start);
+    if (stop == std::string::npos) {
+      stop = _path.size();
+    }
+    std::string key = _path.substr(start, stop - start);
+    if (!value->isObject() || !value->isMember(key)) {
+      if (_required) {
+        fprintf(stderr, "missing setting: sender_config.%s\n", _path.c_str());
+        exit(-1);
+      }
+      return NONE;
+    }
+    value = &(*value)[key];
+    start = stop + 1;
+  }
+  if (value->isNull() || !value->isConvertibleTo(_type)) {
+    fprintf(stderr, "invalid setting: sender_config.%s must be %s\n",
+            _path.c_str(), typeName(_type));
+    exit(-1);
+  }
+  return *value;
+}
+
+void check(bool _valid, const char* _path, const char* _requirement) {
+  if (!_valid) {
+    fprintf(stderr, "invalid setting: sender_config.%s must be %s\n", _path,
+            _requirement);
+    exit(-1);
+  }
+}
+}  // namespace
+
+SenderConfig::SenderConfig(const Json::Value& _settings) {
+  const Json::Value& config = _settings["sender_config"];
+  std::string algorithm = _settings["algorithm"].asString();
+  u32 numSenders = _settings["senders"].asUInt();
+  u32 minMessageSize = _settings["min_message_size"].asUInt();
+  u32 maxMessageSize = _settings["max_message_size"].asUInt();
+
+  // relay parameters
+  bool relay = algorithm == "relay";
+  maxOutstanding =
+      field(config, "max_outstanding", relay, Json::uintValue).asUInt();
+
+  // dist parameters. the tokens are counted in 32 bits by the senders, so
+  //  the type check of max_tokens also verifies its range
+  bool dist = algorithm == "dist";
+  const Json::Value& selection =
+      field(config, "peer_selection", false, Json::stringValue);
+  peerSelection = selection.isNull() ? "random" : selection.asString();
+  maxTokens =
+      field(config, "params.max_tokens", dist, Json::uintValue).asUInt();
+  stealTokens =
+      field(config, "steal_tokens", dist, Json::booleanValue).asBool();
+  stealRate = field(config, "steal_rate", dist, Json::booleanValue).asBool();
+  stealThreshold = field(config, "params.steal_threshold", dist,
+                         Json::realValue).asDouble();
+  tokenAskFactor = field(config, "params.token_ask_factor", dist,
+                         Json::realValue).asDouble();
+  rateAskFactor = field(config, "params.rate_ask_factor", dist,
+                        Json::realValue).asDouble();
+  maxRequestsOutstanding = field(config, "params.max_requests_outstanding",
+                                 dist, Json::uintValue).asUInt();
+  giveTokenThreshold = field(config, "params.give_token_threshold", dist,
+                             Json::realValue).asDouble();
+  giveRateThreshold = field(config, "params.give_rate_threshold", dist,
+                            Json::realValue).asDouble();
+  giveRateFactor = field(config, "params.give_rate_factor", dist,
+                         Json::realValue).asDouble();
+
+  if (relay) {
+    check(maxOutstanding > 0, "max_outstanding", "greater than 0");
+  }
+
+  if (dist) {
+    check(PeerSelector::valid(peerSelection), "peer_selection",
+          "\"random\", \"ring\" or \"generous\"");
+    check(maxTokens >= minMessageSize, "params.max_tokens",
+          "at least min_message_size");
+    check(stealThreshold >= 0.0 && stealThreshold <= 1.0,
+          "params.steal_threshold", "within [0.0, 1.0]");
+    check(tokenAskFactor > 0.0, "params.token_ask_factor",
+          "greater than 0.0");
+    check(rateAskFactor > 0.0 && rateAskFactor <= 1.0,
+          "params.rate_ask_factor", "within (0.0, 1.0]");
+    check(maxRequestsOutstanding > 0, "params.max_requests_outstanding",
+          "greater than 0");
+    check(maxRequestsOutstanding <= numSenders - 1,
+          "params.max_requests_outstanding", "less than the number of senders");
+    check(giveTokenThreshold >= 0.0 && giveTokenThreshold <= 1.0,
+          "params.give_token_threshold", "within [0.0, 1.0]");
+    check(giveRateThreshold >= 0.0 && giveRateThreshold <= 1.0,
+          "params.give_rate_threshold", "within [0.0, 1.0]");
+    check(giveRateFactor > 0.0 && giveRateFactor <= 1.0,
+          "params.give_rate_factor", "within (0.0, 1.0]");
+    if (stealRate) {
+      // there is the case where we have more than the threshold but less
+      //  than the message size. if rate=0, can't every recover
+      check((stealThreshold * maxTokens) >= maxMessageSize,
+            "params.steal_threshold", "large enough to leave max_message_size"
+            " tokens in the bucket when stealing rate");
+    }
+  }
+}
+
+SenderConfig::~SenderConfig() {}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_SENDERCONFIG_H_
+#define RATECONTROL_SENDERCONFIG_H_
+
+#include <jsoncpp/json/json.h>
+#include <prim/prim.h>
+
+#include <string>
+
+/*
+ * This is the typed form of the 'sender_config' settings. It is parsed and
+ *  validated once for the configured algorithm and shared by all senders,
+ *  which keep a const pointer to it. Parameters of other algorithms aren't
+ *  required and are left zero. Invalid settings are reported on stderr and
+ *  end the program, independent of NDEBUG.
+ */
+class SenderConfig {
+ public:
+  /*
+   * '_settings' are the top level settings, the algorithm, number of senders
+   *  and message sizes are needed to validate the sender configuration.
+   */
+  explicit SenderConfig(const Json::Value& _settings);
+  ~SenderConfig();
+
+  // relay parameters
+  u32 maxOutstanding;
+
+  // dist parameters
+  std::string peerSelection;
+  // common parameters
+  u32 maxTokens;  // bucket size
+  // stealing parameters
+  bool stealTokens;
+  bool stealRate;
+  f64 stealThreshold;  // bucket percentage
+  f64 tokenAskFactor;  // bucket percentage of not filled portion
+  f64 rateAskFactor;  // percentage of not used rate to 1.0 div by reqs
+  u32 maxRequestsOutstanding;
+  // giving parameters
+  f64 giveTokenThreshold;  // bucket percentage
+  f64 giveRateThreshold;  // bucket percentage
+  f64 giveRateFactor;
+};
+
+#endif  // RATECONTROL_SENDERCONFIG_H_
@@ -38,19 +38,31 @@
 #include <string>
 #include <vector>
 
-#include "ratecontrol/Sender.h"
+#include "ratecontrol/RateSchedule.h"
 
+/*
+ * This controls the injection rates of a set of senders over time. 'S' is the
+ *  concrete sender type. The schedule is parsed once and shared with the
+ *  senders, which read their rate from it. Only the senders whose rate turns
+ *  on need an event, all of them are started by a single event per step.
+ */
+template <typename S>
 class SenderControl : public des::Model {
  public:
   SenderControl(des::Simulator* _sim, const std::string& _name,
-                const des::Model* _parent, std::vector<Sender*>* _senders,
+                const des::Model* _parent, std::vector<S*>* _senders,
                 Json::Value _settings);
   ~SenderControl();
 
  private:
   void handle_rateChange(des::Event* _event);
 
-  std::vector<Sender*>* senders_;
+  std::vector<S*>* senders_;
+  RateSchedule schedule_;
+  u32 next_;  // the next entry of the schedule to process
+  std::vector<f64> rates_;  // the rate of each sender as last scheduled
 };
 
+#include "ratecontrol/SenderControl.tcc"
+
 #endif  // RATECONTROL_SENDERCONTROL_H_
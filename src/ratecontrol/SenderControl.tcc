@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_SENDERCONTROL_H_
+#error "do not include this file, include SenderControl.h instead"
+#endif  // RATECONTROL_SENDERCONTROL_H_
+
+#include <cassert>
+
+#include <typeinfo>
+#include <vector>
+
+#include "ratecontrol/Profiler.h"
+
+template <typename S>
+SenderControl<S>::SenderControl(des::Simulator* _sim, const std::string& _name,
+                                const des::Model* _parent,
+                                std::vector<S*>* _senders,
+                                Json::Value _settings)
+    : des::Model(_sim, _name, _parent), senders_(_senders),
+      schedule_(_settings, _senders->size()), next_(0),
+      rates_(_senders->size(), 0.0) {
+  // give the senders the schedule
+  for (u32 idx = 0; idx < senders_->size(); idx++) {
+    senders_->at(idx)->setRateSchedule(&schedule_, idx);
+  }
+
+  // add an event for each tick in the schedule
+  const std::vector<RateSchedule::Change>& changes = schedule_.changes();
+  for (u32 idx = 0; idx < changes.size(); idx++) {
+    if (idx == 0 || changes[idx].tick != changes[idx - 1].tick) {
+      simulator->addEvent(new des::Event(
+          this,
+          static_cast<des::EventHandler>(&SenderControl::handle_rateChange),
+          des::Time(changes[idx].tick)));
+    }
+  }
+}
+
+template <typename S>
+SenderControl<S>::~SenderControl() {}
+
+template <typename S>
+void SenderControl<S>::handle_rateChange(des::Event* _event) {
+  static const u32 SITE =
+      Profiler::site(typeid(SenderControl), "handle_rateChange");
+  ProfileProbe probe(SITE);
+  // the senders apply the rate at (tick, RateSchedule::EPSILON) and start
+  //  generating the epsilon after that
+  des::Tick tick = simulator->time().tick;
+  des::Time start(tick, RateSchedule::EPSILON + 1);
+
+  // start all senders that turn on
+  const std::vector<RateSchedule::Change>& changes = schedule_.changes();
+  for (; next_ < changes.size() && changes[next_].tick == tick; next_++) {
+    const RateSchedule::Change& change = changes[next_];
+    for (u32 idx = change.first; idx <= change.last; idx++) {
+      if (rates_[idx] == 0.0 && change.rate > 0.0) {
+        senders_->at(idx)->startInjection(idx, start);
+      }
+      rates_[idx] = change.rate;
+    }
+  }
+  assert(next_ == changes.size() || changes[next_].tick > tick);
+  delete _event;
+}
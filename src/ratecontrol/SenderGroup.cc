@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/SenderGroup.h"
+
+#include <cassert>
+
+#include <typeinfo>
+
+#include "ratecontrol/MemoryStats.h"
+#include "ratecontrol/Message.h"
+#include "ratecontrol/Network.h"
+#include "ratecontrol/PhaseStats.h"
+#include "ratecontrol/Profiler.h"
+#include "trace/TraceWriter.h"
+
+SenderGroup::SenderGroup(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    u32 _firstId, u32 _senders, Network* _network, bool _relay,
+    u32 _minMessageSize, u32 _maxMessageSize, u32 _receiverMinId,
+    u32 _receiverMaxId, const SenderConfig* _config)
+    : Node(_sim, _name, _parent, _firstId, _network,
+           static_cast<des::EventHandler>(&SenderGroup::handle_recv)),
+      senders(_senders), relay_(_relay), minMessageSize_(_minMessageSize),
+      maxMessageSize_(_maxMessageSize), receiverMinId_(_receiverMinId),
+      receiverMaxId_(_receiverMaxId),
+      maxOutstanding_(_relay ? _config->maxOutstanding : 0),
+      relayMinId_(0), relayMaxId_(0), schedule_(nullptr), scheduleIndex_(0),
+      rates_(_senders, 0.0), cursors_(_senders, 0),
+      messageCounts_(_senders, 0),
+      credits_(_relay ? _senders : 0, maxOutstanding_),
+      relayReqIds_(_relay ? _senders : 0, 0),
+      timer_(this, static_cast<Timer::Handler>(&SenderGroup::generate)) {
+  assert(senders > 0);
+  assert(!relay_ || maxOutstanding_ > 0);  // verified by SenderConfig
+
+  // the first id is registered by Node
+  network_->registerRange(id + 1, senders - 1, this);
+}
+
+SenderGroup::~SenderGroup() {}
+
+void SenderGroup::relayIds(u32 _relayMinId, u32 _relayMaxId) {
+  relayMinId_ = _relayMinId;
+  relayMaxId_ = _relayMaxId;
+}
+
+void SenderGroup::setRateSchedule(const RateSchedule* _schedule, u32 _index) {
+  // called once for each logical sender, in order
+  if (schedule_ == nullptr) {
+    schedule_ = _schedule;
+    scheduleIndex_ = _index;
+  }
+  assert(schedule_ == _schedule);
+  assert(_index >= scheduleIndex_ && _index < scheduleIndex_ + senders);
+}
+
+void SenderGroup::startInjection(u32 _index, des::Time _time) {
+  // only add an event, this is called by another model
+  assert(_index >= scheduleIndex_ && _index < scheduleIndex_ + senders);
+  simulator->addEvent(new des::ItemEvent<u32>(
+      this, static_cast<des::EventHandler>(&SenderGroup::handle_start),
+      _time, _index - scheduleIndex_));
+}
+
+void SenderGroup::handle_recv(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(SenderGroup), "handle_recv");
+  ProfileProbe probe(SITE);
+  MessageEvent* evt = reinterpret_cast<MessageEvent*>(_event);
+  Message* msg = evt->msg;
+  delete evt;
+  dlogf("%s", msg->toString().c_str());
+  if (trace_ != nullptr) {
+    trace_->write(simulator->time().tick, TraceRecord::RECV, msg->dst,
+                  msg->src, msg->size, msg->trans, msg->type);
+  }
+  if (bandwidth_ != nullptr) {
+    bandwidth_->recordRecv(nodeClass_, simulator->time().tick, msg->size,
+                           msg->type != Message::PLAIN);
+  }
+  if (phaseStats_ != nullptr && msg->type != Message::PLAIN) {
+    // all control traffic is overhead
+    phaseStats_->recordOverhead(simulator->time().tick, msg->size);
+  }
+
+  // only relay senders receive messages, the responses return credits
+  assert(relay_);
+  assert(msg->type == Message::RELAY_RESPONSE);
+  u32 sender = msg->dst - id;
+  assert(sender < senders);
+  delete msg;
+  assert(credits_[sender] < maxOutstanding_);
+  credits_[sender]++;
+  drain(sender);
+}
+
+void SenderGroup::handle_start(des::Event* _event) {
+  static const u32 SITE = Profiler::site(typeid(SenderGroup), "handle_start");
+  ProfileProbe probe(SITE);
+  des::ItemEvent<u32>* evt = reinterpret_cast<des::ItemEvent<u32>*>(_event);
+  u32 sender = evt->item;
+  delete evt;
+  handle_sendMessage(sender);
+  rearm();
+}
+
+void SenderGroup::generate() {
+  static const u32 SITE = Profiler::site(typeid(SenderGroup), "generate");
+  ProfileProbe probe(SITE);
+  des::Tick now = simulator->time().tick;
+  while (!due_.empty() && due_.top().first <= now) {
+    u32 sender = due_.top().second;
+    due_.pop();
+    handle_sendMessage(sender);
+  }
+  rearm();
+}
+
+void SenderGroup::handle_sendMessage(u32 _sender) {
+  // apply any rate changes that have taken effect
+  schedule_->advance(scheduleIndex_ + _sender, simulator->time(),
+                     &cursors_[_sender], &rates_[_sender]);
+
+  // create and send a message
+  u32 src = id + _sender;
+  u32 dst = prng.nextU64(receiverMinId_, receiverMaxId_);
+  u32 size = prng.nextU64(minMessageSize_, maxMessageSize_);
+  u64 trans = ((u64)src << 32) | ((u64)messageCounts_[_sender]);
+  dlogf("trans=%lu size=%u", trans, size);
+  if (trace_ != nullptr) {
+    trace_->write(simulator->time().tick, TraceRecord::CREATE, src, dst, size,
+                  trans, Message::PLAIN);
+  }
+  messageCounts_[_sender]++;
+  Message* msg = new Message(src, dst, size, trans, Message::PLAIN,
+                             simulator->time().tick);
+  if (relay_) {
+    relay(_sender, msg);
+  } else {
+    handle_send(msg);
+  }
+
+  // schedule the next message
+  if (rates_[_sender] > 0.0) {
+    due_.push(Due(simulator->time().tick +
+                  cyclesToSend(size, rates_[_sender]), _sender));
+  }
+}
+
+void SenderGroup::handle_send(Message* _msg) {
+  const Network::Entry& dst = network_->getEntry(_msg->dst);
+  des::Time now = simulator->time();
+  des::Time recvTime(now + _msg->size + dst.delay);
+  dst.node->future_recv(_msg, recvTime);
+  dlogf("%s", _msg->toString().c_str());
+  if (trace_ != nullptr) {
+    trace_->write(now.tick, TraceRecord::SEND, _msg->src, _msg->dst,
+                  _msg->size, _msg->trans, _msg->type);
+  }
+  if (bandwidth_ != nullptr) {
+    bandwidth_->recordSend(nodeClass_, now.tick, _msg->size,
+                           _msg->type != Message::PLAIN);
+  }
+}
+
+void SenderGroup::relay(u32 _sender, Message* _msg) {
+  // reformat the message to be a relay request
+  u32 msgDst = _msg->dst;
+  _msg->dst = prng.nextU64(relayMinId_, relayMaxId_);
+  _msg->size++;  // increase for request header
+  _msg->type = Message::RELAY_REQUEST;
+  RelayRequest* req = _msg->relayRequest();
+  req->reqId = relayReqIds_[_sender];
+  relayReqIds_[_sender]++;
+  req->msgDst = msgDst;
+
+  // send it if there is a credit, messages only wait when there is none
+  if (credits_[_sender] > 0) {
+    assert(waiting_.count(_sender) == 0);
+    credits_[_sender]--;
+    handle_send(_msg);
+  } else {
+    waiting_[_sender].push(_msg);
+    MemoryStats::push(nodeClass_, _msg->size);
+  }
+}
+
+void SenderGroup::drain(u32 _sender) {
+  std::unordered_map<u32, std::queue<Message*> >::iterator it =
+      waiting_.find(_sender);
+  if (it == waiting_.end()) {
+    return;
+  }
+  std::queue<Message*>& queue = it->second;
+  while (!queue.empty() && credits_[_sender] > 0) {
+    Message* msg = queue.front();
+    queue.pop();
+    MemoryStats::pop(nodeClass_, msg->size);
+    handle_send(msg);
+    credits_[_sender]--;
+  }
+  if (queue.empty()) {
+    waiting_.erase(it);
+  }
+}
+
+void SenderGroup::rearm() {
+  if (!due_.empty()) {
+    des::Time next(due_.top().first);
+    if (!timer_.armed() || next < timer_.time()) {
+      timer_.set(next);
+    }
+  }
+}
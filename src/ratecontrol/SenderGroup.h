@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_SENDERGROUP_H_
+#define RATECONTROL_SENDERGROUP_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <functional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ratecontrol/Node.h"
+#include "ratecontrol/RateSchedule.h"
+#include "ratecontrol/SenderConfig.h"
+
+class Message;
+class Network;
+
+/*
+ * This is a single model generating the superposed traffic of a group of
+ *  logical basic or relay senders with consecutive ids. Each logical sender
+ *  keeps its own id (for 'src' and 'trans'), rate, message count and relay
+ *  credits, stored in flat arrays. Generation times are kept in a heap and
+ *  all messages due in the same tick are generated by one event. As in
+ *  QueuedNode, a message is transmitted as soon as it is handed to the egress
+ *  port (the port is never held busy by the previous message), so sending
+ *  needs no per-port state or events.
+ */
+class SenderGroup : public Node {
+ public:
+  SenderGroup(des::Simulator* _sim, const std::string& _name,
+              const des::Model* _parent, u32 _firstId, u32 _senders,
+              Network* _network, bool _relay, u32 _minMessageSize,
+              u32 _maxMessageSize, u32 _receiverMinId, u32 _receiverMaxId,
+              const SenderConfig* _config);
+  ~SenderGroup();
+
+  void relayIds(u32 _relayMinId, u32 _relayMaxId);
+
+  // these are the interface used by SenderControl, '_index' is the position
+  //  of a logical sender in the schedule
+  void setRateSchedule(const RateSchedule* _schedule, u32 _index);
+  void startInjection(u32 _index, des::Time _time);
+
+  const u32 senders;  // the number of logical senders
+
+ private:
+  typedef std::pair<des::Tick, u32> Due;  // (tick, logical sender)
+
+  void handle_recv(des::Event* _event);
+  void handle_start(des::Event* _event);
+
+  // this generates all messages due now (timer handler)
+  void generate();
+
+  // these have the names of the Sender and QueuedNode event handlers they
+  //  replace, the log parsers depend on them
+  void handle_sendMessage(u32 _sender);
+  void handle_send(Message* _msg);
+
+  void relay(u32 _sender, Message* _msg);
+  void drain(u32 _sender);
+  void rearm();
+
+  const bool relay_;
+  const u32 minMessageSize_;
+  const u32 maxMessageSize_;
+  const u32 receiverMinId_;
+  const u32 receiverMaxId_;
+  const u32 maxOutstanding_;
+  u32 relayMinId_;
+  u32 relayMaxId_;
+
+  const RateSchedule* schedule_;
+  u32 scheduleIndex_;  // of the first logical sender
+
+  // per logical sender state
+  std::vector<f64> rates_;
+  std::vector<u32> cursors_;
+  std::vector<u32> messageCounts_;
+  std::vector<u32> credits_;
+  std::vector<u64> relayReqIds_;
+  std::unordered_map<u32, std::queue<Message*> > waiting_;  // for credits
+
+  std::priority_queue<Due, std::vector<Due>, std::greater<Due> > due_;
+  Timer timer_;
+};
+
+#endif  // RATECONTROL_SENDERGROUP_H_
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_SENDERSAMPLER_H_
+#define RATECONTROL_SENDERSAMPLER_H_
+
+#include <des/des.h>
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * This periodically samples the state of a set of senders and logs all of
+ *  them as one record per sample. 'S' is the concrete sender type and must
+ *  provide sample(u32*, f64*, u64*, u32*). Samples are taken every '_period'
+ *  ticks from tick 0 until the first one past '_horizon', i.e. up to tick
+ *  91000 for a period of 1000 and a horizon of 90000.
+ */
+template <typename S>
+class SenderSampler : public des::Model {
+ public:
+  SenderSampler(des::Simulator* _sim, const std::string& _name,
+                const des::Model* _parent, const std::vector<S*>* _senders,
+                des::Tick _period, des::Tick _horizon);
+  ~SenderSampler();
+
+  // samples are taken after the senders' events of the same tick
+  static const des::Epsilon EPSILON = 250;
+
+ private:
+  void handle_sample(des::Event* _event);
+
+  const std::vector<S*>* senders_;
+  const des::Tick period_;
+  const des::Tick horizon_;
+
+  // the last snapshot as a structure of arrays
+  std::vector<u32> tokens_;
+  std::vector<f64> rates_;
+  std::vector<u64> queueSizes_;
+  std::vector<u32> outstanding_;
+};
+
+#include "ratecontrol/SenderSampler.tcc"
+
+#endif  // RATECONTROL_SENDERSAMPLER_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef RATECONTROL_SENDERSAMPLER_H_
+#error "do not include this file, include SenderSampler.h instead"
+#endif  // RATECONTROL_SENDERSAMPLER_H_
+
+#include <cassert>
+
+#include <sstream>
+#include <typeinfo>
+
+#include "ratecontrol/Profiler.h"
+
+template <typename S>
+SenderSampler<S>::SenderSampler(
+    des::Simulator* _sim, const std::string& _name, const des::Model* _parent,
+    const std::vector<S*>* _senders, des::Tick _period, des::Tick _horizon)
+    : des::Model(_sim, _name, _parent), senders_(_senders), period_(_period),
+      horizon_(_horizon), tokens_(_senders->size()), rates_(_senders->size()),
+      queueSizes_(_senders->size()), outstanding_(_senders->size()) {
+  assert(period_ > 0);
+  simulator->addEvent(new des::Event(
+      this, static_cast<des::EventHandler>(&SenderSampler::handle_sample),
+      des::Time(0, EPSILON)));
+}
+
+template <typename S>
+SenderSampler<S>::~SenderSampler() {}
+
+template <typename S>
+void SenderSampler<S>::handle_sample(des::Event* _event) {
+  static const u32 SITE =
+      Profiler::site(typeid(SenderSampler), "handle_sample");
+  ProfileProbe probe(SITE);
+  // take the snapshot
+  u32 numSenders = senders_->size();
+  for (u32 s = 0; s < numSenders; s++) {
+    senders_->at(s)->sample(&tokens_[s], &rates_[s], &queueSizes_[s],
+                            &outstanding_[s]);
+  }
+
+  // log it as a single record
+  if (debug) {
+    std::stringstream ss;
+    ss << "tokens=";
+    for (u32 s = 0; s < numSenders; s++) {
+      ss << (s ? "," : "") << tokens_[s];
+    }
+    ss << " rate=";
+    for (u32 s = 0; s < numSenders; s++) {
+      ss << (s ? "," : "") << rates_[s];
+    }
+    ss << " queue=";
+    for (u32 s = 0; s < numSenders; s++) {
+      ss << (s ? "," : "") << queueSizes_[s];
+    }
+    ss << " outstanding=";
+    for (u32 s = 0; s < numSenders; s++) {
+      ss << (s ? "," : "") << outstanding_[s];
+    }
+    dlogf("%s", ss.str().c_str());
+  }
+
+  // schedule the next sample while this one is within the horizon
+  if (simulator->time().tick <= horizon_) {
+    simulator->addEvent(new des::Event(
+        this, static_cast<des::EventHandler>(&SenderSampler::handle_sample),
+        des::Time(simulator->time().tick + period_, EPSILON)));
+  }
+  delete _event;
+}
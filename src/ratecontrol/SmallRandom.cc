@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ratecontrol/SmallRandom.h"
+
+#include <cassert>
+
+namespace {
+u64 rotl(u64 _x, u32 _k) {
+  return (_x << _k) | (_x >> (64 - _k));
+}
+}  // namespace
+
+SmallRandom::SmallRandom() {
+  seed(0);
+}
+
+SmallRandom::~SmallRandom() {}
+
+void SmallRandom::seed(u64 _seed) {
+  // expand the seed with splitmix64, the state can't be all zeros
+  for (u32 idx = 0; idx < 4; idx++) {
+    u64 z = (_seed += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    state_[idx] = z ^ (z >> 31);
+  }
+}
+
+u64 SmallRandom::nextU64() {
+  u64 result = rotl(state_[1] * 5, 7) * 9;
+  u64 t = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+u64 SmallRandom::nextU64(u64 _min, u64 _max) {
+  assert(_min <= _max);
+  u64 range = _max - _min + 1;
+  if (range == 0) {
+    return nextU64();  // the full range
+  }
+  // reject the values that would bias the modulo
+  u64 threshold = (0 - range) % range;
+  u64 value;
+  do {
+    value = nextU64();
+  } while (value < threshold);
+  return _min + value % range;
+}
+
+f64 SmallRandom::nextF64() {
+  return (nextU64() >> 11) * (1.0 / 9007199254740992.0);
+}
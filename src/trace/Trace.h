@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TRACE_TRACE_H_
+#define TRACE_TRACE_H_
+
+#include <prim/prim.h>
+
+/*
+ * A binary trace file is a FileHeader followed by blocks. Each block is a
+ *  BlockHeader followed by 'storedSize' bytes holding 'rawSize' bytes of
+ *  TraceRecords, zlib compressed if the file is flagged as compressed. All
+ *  values are in host byte order. Records are time ordered within the writing
+ *  thread only, blocks from different threads are interleaved.
+ */
+struct TraceRecord {
+  u64 tick;
+  u64 trans;
+  u32 node;   // the node performing the action
+  u32 peer;   // the other end (dst for send/create, src for recv)
+  u32 size;
+  u8 type;    // the message type
+  u8 event;   // the action
+  u8 pad[2];
+
+  static const u8 SEND = 0;    // Node::handle_send
+  static const u8 RECV = 1;    // Node::handle_recv
+  static const u8 CREATE = 2;  // Sender::handle_sendMessage
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must be 32 bytes");
+
+struct TraceFileHeader {
+  char magic[8];
+  u32 version;
+  u32 flags;
+  u32 recordSize;
+  u32 pad;
+
+  static const u32 VERSION = 1;
+  static const u32 COMPRESSED = 0x1;
+};
+
+struct TraceBlockHeader {
+  u32 rawSize;
+  u32 storedSize;
+};
+
+extern const char TRACE_MAGIC[8];
+
+#endif  // TRACE_TRACE_H_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "trace/TraceReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+TraceReader::TraceReader(const std::string& _filename) {
+  s32 fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "couldn't open trace file: %s\n", _filename.c_str());
+    exit(-1);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (u64)st.st_size < sizeof(TraceFileHeader)) {
+    fprintf(stderr, "invalid trace file: %s\n", _filename.c_str());
+    exit(-1);
+  }
+  mapSize_ = st.st_size;
+  void* map = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "couldn't map trace file: %s\n", _filename.c_str());
+    exit(-1);
+  }
+  map_ = reinterpret_cast<const u8*>(map);
+  madvise(map, mapSize_, MADV_SEQUENTIAL);
+
+  TraceFileHeader header;
+  memcpy(&header, map_, sizeof(header));
+  if (memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != TraceFileHeader::VERSION ||
+      header.recordSize != sizeof(TraceRecord)) {
+    fprintf(stderr, "invalid trace file: %s\n", _filename.c_str());
+    exit(-1);
+  }
+  compressed_ = (header.flags & TraceFileHeader::COMPRESSED) != 0;
+
+  rewind();
+}
+
+TraceReader::~TraceReader() {
+  munmap(const_cast<u8*>(map_), mapSize_);
+}
+
+bool TraceReader::compressed() const {
+  return compressed_;
+}
+
+const TraceRecord* TraceReader::next() {
+  while (blockIndex_ == blockCount_) {
+    block_ = nextBlock(&blockCount_);
+    blockIndex_ = 0;
+    if (block_ == nullptr) {
+      blockCount_ = 0;  // stay at the end on further calls
+      return nullptr;
+    }
+  }
+  return &block_[blockIndex_++];
+}
+
+const TraceRecord* TraceReader::nextBlock(u64* _count) {
+  if (offset_ + sizeof(TraceBlockHeader) > mapSize_) {
+    return nullptr;
+  }
+  TraceBlockHeader block;
+  memcpy(&block, map_ + offset_, sizeof(block));
+  const u8* data = map_ + offset_ + sizeof(block);
+  if (offset_ + sizeof(block) + block.storedSize > mapSize_ ||
+      block.rawSize % sizeof(TraceRecord) != 0) {
+    fprintf(stderr, "truncated trace file\n");
+    exit(-1);
+  }
+  offset_ += sizeof(block) + block.storedSize;
+  *_count = block.rawSize / sizeof(TraceRecord);
+
+  if (!compressed_) {
+    // blocks are a multiple of 8 bytes so records stay aligned
+    return reinterpret_cast<const TraceRecord*>(data);
+  }
+  inflated_.resize(*_count);
+  uLongf size = block.rawSize;
+  if (uncompress(reinterpret_cast<Bytef*>(inflated_.data()), &size, data,
+                 block.storedSize) != Z_OK || size != block.rawSize) {
+    fprintf(stderr, "corrupt trace block\n");
+    exit(-1);
+  }
+  return inflated_.data();
+}
+
+void TraceReader::rewind() {
+  offset_ = sizeof(TraceFileHeader);
+  block_ = nullptr;
+  blockCount_ = 0;
+  blockIndex_ = 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TRACE_TRACEREADER_H_
+#define TRACE_TRACEREADER_H_
+
+#include <prim/prim.h>
+
+#include <string>
+#include <vector>
+
+#include "trace/Trace.h"
+
+/*
+ * This reads a binary trace file by memory mapping it. Records of
+ *  uncompressed files are returned directly from the mapping, compressed
+ *  blocks are inflated one at a time into an internal buffer.
+ */
+class TraceReader {
+ public:
+  explicit TraceReader(const std::string& _filename);
+  ~TraceReader();
+
+  bool compressed() const;
+
+  /*
+   * This returns the next record or nullptr at the end of the file. The
+   *  record is only valid until the next call.
+   */
+  const TraceRecord* next();
+
+  /*
+   * This returns the next block of records and sets '_count' to the number of
+   *  records in it, or returns nullptr at the end of the file.
+   */
+  const TraceRecord* nextBlock(u64* _count);
+
+  void rewind();
+
+ private:
+  const u8* map_;
+  u64 mapSize_;
+  bool compressed_;
+
+  u64 offset_;  // offset of the next block
+  const TraceRecord* block_;
+  u64 blockCount_;
+  u64 blockIndex_;
+  std::vector<TraceRecord> inflated_;
+};
+
+#endif  // TRACE_TRACEREADER_H_
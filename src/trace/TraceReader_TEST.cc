@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <prim/prim.h>
+
+#include <unistd.h>
+
+#include <cassert>
+
+#include <string>
+
+#include "trace/TraceReader.h"
+#include "trace/TraceWriter.h"
+
+namespace {
+
+std::string tempFile() {
+  char name[] = "/tmp/TraceReader_TEST_XXXXXX";
+  s32 fd = mkstemp(name);
+  assert(fd >= 0);
+  close(fd);
+  return name;
+}
+
+void roundTrip(bool _compress) {
+  // several full blocks and a partial one
+  const u64 RECORDS = 2 * TraceWriter::BLOCK_RECORDS + 17;
+  std::string filename = tempFile();
+  {
+    TraceWriter writer(filename, _compress);
+    for (u64 idx = 0; idx < RECORDS; idx++) {
+      writer.write(idx, idx % 3, idx * 2, idx * 2 + 1, idx % 80 + 1,
+                   idx << 32, idx % 4);
+    }
+  }
+
+  TraceReader reader(filename);
+  ASSERT_EQ(reader.compressed(), _compress);
+  for (u32 pass = 0; pass < 2; pass++) {
+    for (u64 idx = 0; idx < RECORDS; idx++) {
+      const TraceRecord* rec = reader.next();
+      ASSERT_NE(rec, nullptr);
+      ASSERT_EQ(rec->tick, idx);
+      ASSERT_EQ(rec->event, idx % 3);
+      ASSERT_EQ(rec->node, idx * 2);
+      ASSERT_EQ(rec->peer, idx * 2 + 1);
+      ASSERT_EQ(rec->size, idx % 80 + 1);
+      ASSERT_EQ(rec->trans, idx << 32);
+      ASSERT_EQ(rec->type, idx % 4);
+    }
+
+    // the end of the file must be sticky
+    for (u32 call = 0; call < 3; call++) {
+      ASSERT_EQ(reader.next(), nullptr);
+    }
+    u64 count;
+    ASSERT_EQ(reader.nextBlock(&count), nullptr);
+    ASSERT_EQ(reader.next(), nullptr);
+    reader.rewind();
+  }
+
+  unlink(filename.c_str());
+}
+
+}  // namespace
+
+TEST(TraceReader, plain) {
+  roundTrip(false);
+}
+
+TEST(TraceReader, compressed) {
+  roundTrip(true);
+}
+
+TEST(TraceReader, empty) {
+  std::string filename = tempFile();
+  {
+    TraceWriter writer(filename, false);
+  }
+  TraceReader reader(filename);
+  ASSERT_EQ(reader.next(), nullptr);
+  ASSERT_EQ(reader.next(), nullptr);
+  unlink(filename.c_str());
+}
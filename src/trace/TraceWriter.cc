@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "trace/TraceWriter.h"
+
+#include <zlib.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+TraceWriter::TraceWriter(const std::string& _filename, bool _compress)
+    : compress_(_compress),
+      buffers_([] {
+          Buffer* b = new Buffer();
+          b->records.reserve(BLOCK_RECORDS);
+          return b;
+        }) {
+  file_ = fopen(_filename.c_str(), "wb");
+  if (file_ == nullptr) {
+    fprintf(stderr, "couldn't open trace file: %s\n", _filename.c_str());
+    exit(-1);
+  }
+
+  TraceFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+  header.version = TraceFileHeader::VERSION;
+  header.flags = compress_ ? TraceFileHeader::COMPRESSED : 0;
+  header.recordSize = sizeof(TraceRecord);
+  fwrite(&header, sizeof(header), 1, file_);
+}
+
+TraceWriter::~TraceWriter() {
+  close();
+}
+
+void TraceWriter::write(u64 _tick, u8 _event, u32 _node, u32 _peer,
+                        u32 _size, u64 _trans, u8 _type) {
+  Buffer* b = buffers_.get();
+  b->records.push_back(TraceRecord());
+  TraceRecord& rec = b->records.back();
+  rec.tick = _tick;
+  rec.trans = _trans;
+  rec.node = _node;
+  rec.peer = _peer;
+  rec.size = _size;
+  rec.type = _type;
+  rec.event = _event;
+  rec.pad[0] = 0;
+  rec.pad[1] = 0;
+  if (b->records.size() == BLOCK_RECORDS) {
+    flush(b);
+  }
+}
+
+void TraceWriter::close() {
+  if (file_ == nullptr) {
+    return;
+  }
+  for (Buffer* buffer : buffers_.all()) {
+    flush(buffer);
+  }
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void TraceWriter::flush(Buffer* _buffer) {
+  if (_buffer->records.empty()) {
+    return;
+  }
+  TraceBlockHeader block;
+  block.rawSize = _buffer->records.size() * sizeof(TraceRecord);
+  const void* data = _buffer->records.data();
+
+  // compress outside of the lock
+  if (compress_) {
+    uLongf size = compressBound(block.rawSize);
+    _buffer->scratch.resize(size);
+    s32 res = compress2(_buffer->scratch.data(), &size,
+                        reinterpret_cast<const Bytef*>(data), block.rawSize,
+                        Z_BEST_SPEED);
+    assert(res == Z_OK);
+    (void)res;  // unused with NDEBUG
+    block.storedSize = size;
+    data = _buffer->scratch.data();
+  } else {
+    block.storedSize = block.rawSize;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    fwrite(&block, sizeof(block), 1, file_);
+    fwrite(data, 1, block.storedSize, file_);
+  }
+  _buffer->records.clear();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2012-2015, Nic McDonald
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of prim nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TRACE_TRACEWRITER_H_
+#define TRACE_TRACEWRITER_H_
+
+#include <prim/prim.h>
+
+#include <cstdio>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ratecontrol/PerThread.h"
+#include "trace/Trace.h"
+
+/*
+ * This writes a binary trace file. Each thread appends records to its own
+ *  buffer without locking. Full buffers are optionally compressed and then
+ *  written as a block under a lock.
+ */
+class TraceWriter {
+ public:
+  TraceWriter(const std::string& _filename, bool _compress);
+  ~TraceWriter();
+
+  void write(u64 _tick, u8 _event, u32 _node, u32 _peer, u32 _size,
+             u64 _trans, u8 _type);
+
+  /*
+   * This flushes all buffers and closes the file. It must only be called when
+   *  no other thread is writing.
+   */
+  void close();
+
+  static const u32 BLOCK_RECORDS = 4096;
+
+ private:
+  struct Buffer {
+    std::vector<TraceRecord> records;
+    std::vector<u8> scratch;
+  };
+
+  void flush(Buffer* _buffer);
+
+  const bool compress_;
+  FILE* file_;
+  std::mutex lock_;  // for the file
+  PerThread<Buffer> buffers_;
+};
+
+#endif  // TRACE_TRACEWRITER_H_